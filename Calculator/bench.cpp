@@ -0,0 +1,319 @@
+// bench.cpp
+// Benchmarks for the calculator engine (C++17)
+// - Batch evaluation: expressions per second for parse only and for
+//   parse + evaluate over a generated script of random expressions.
+// - Checked mul: ns/op for the old throw/catch/print version against the
+//   CalcResult version over workloads with 0..50% overflowing inputs.
+// Build:
+//   g++ -std=c++17 -O2 -pthread bench.cpp calculator.cpp engine.cpp vm.cpp memo.cpp -o bench
+// Run:
+//   ./bench [count] [array elements]
+
+#include "calculator.hpp"
+#include "engine.hpp"
+#include "memo.hpp"
+#include "vm.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsed_ms(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static void report(const char* name, std::size_t n, double ms) {
+    std::cout << std::left << std::setw(24) << name
+              << " expressions=" << std::setw(10) << n
+              << " ms=" << std::setw(10) << ms
+              << " expr/s=" << n / (ms / 1000.0) << std::endl;
+}
+
+// Operands stay >= 2 so no template hits an error path.
+static std::string make_script(std::size_t n) {
+    static const char* templates[] = {
+        "a + b * c",
+        "(a + b) / c",
+        "sqrt(a) * b + c",
+        "log(a + b, 2) * c",
+        "pow(a, 2) + b / c",
+        "root(a * b, 3) + c",
+        "a * (b + c) / (a + c)",
+    };
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> pick(0, 6);
+    std::uniform_real_distribution<double> num(2.0, 100.0);
+
+    std::string script;
+    script.reserve(n * 24);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (const char* p = templates[pick(rng)]; *p; ++p) {
+            if (*p == 'a' || *p == 'b' || *p == 'c') script += std::to_string(num(rng)).substr(0, 6);
+            else script += *p;
+        }
+        script += '\n';
+    }
+    return script;
+}
+
+// mul() as it was before CalcResult: range checks, throw, catch, print.
+static double legacy_mul(double a, double b) {
+    const double max = std::numeric_limits<double>::max();
+    const double min = std::numeric_limits<double>::min();
+    try {
+        if (b != 0 && (a > max / b || a < min / b))
+            throw std::overflow_error("Double cant contain your result.");
+        return a * b;
+    }
+    catch (const std::exception &e) {
+        std::cout << e.what() << std::endl;
+        return 0;
+    }
+}
+
+static void bench_checked(std::size_t n) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> small(1.0, 1000.0);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<double> a(n), b(n);
+
+    // Messages from legacy_mul go to a discarded buffer, not the terminal.
+    std::ostringstream sink;
+    std::streambuf* old = std::cout.rdbuf(sink.rdbuf());
+
+    double rates[] = {0.0, 0.01, 0.1, 0.5};
+    std::vector<std::string> lines;
+    for (double rate : rates) {
+        for (std::size_t i = 0; i < n; ++i) {
+            bool overflow = unit(rng) < rate;
+            a[i] = overflow ? 1e200 : small(rng);
+            b[i] = overflow ? 1e200 : small(rng);
+        }
+
+        double sum = 0;
+        auto start = Clock::now();
+        for (std::size_t i = 0; i < n; ++i) sum += legacy_mul(a[i], b[i]);
+        double legacy_ms = elapsed_ms(start);
+        sink.str("");
+
+        std::size_t failed = 0;
+        start = Clock::now();
+        for (std::size_t i = 0; i < n; ++i) {
+            CalcResult r = mul(a[i], b[i]);
+            sum += r.value;
+            failed += !r.ok();
+        }
+        double result_ms = elapsed_ms(start);
+
+        std::ostringstream line;
+        line << "overflow=" << std::setw(5) << rate
+             << " legacy ns/op=" << std::setw(10) << legacy_ms * 1e6 / n
+             << " CalcResult ns/op=" << std::setw(10) << result_ms * 1e6 / n
+             << " failed=" << failed << " (checksum " << sum << ")";
+        lines.push_back(line.str());
+    }
+
+    std::cout.rdbuf(old);
+    for (const std::string& line : lines) std::cout << line << std::endl;
+}
+
+using ArrayOp = StatusBitmap (*)(const double*, const double*, double*, std::size_t);
+using ScalarOp = CalcResult (*)(double, double);
+
+static void bench_arrays(std::size_t total) {
+    const std::size_t block = 1 << 20;
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> num(0.5, 100.0);
+    std::vector<double> a(block), b(block), out(block);
+    for (std::size_t i = 0; i < block; ++i) {
+        a[i] = num(rng);
+        b[i] = num(rng);
+    }
+    // A few failing lanes per block so the masks are exercised.
+    for (std::size_t i = 0; i < block; i += 997) b[i] = 0;
+
+    struct Case { const char* name; ArrayOp array; ScalarOp scalar; };
+    Case cases[] = {
+        {"add", add, add}, {"sub", sub, sub}, {"mul", mul, mul}, {"div", div, div},
+        {"ppow", ppow, ppow}, {"llog", llog, llog}, {"ssqrt", ssqrt, ssqrt},
+    };
+
+    for (const Case& c : cases) {
+        std::size_t failed = 0;
+        auto start = Clock::now();
+        for (std::size_t done = 0; done < total; done += block) {
+            std::size_t n = std::min(block, total - done);
+            for (std::size_t i = 0; i < n; ++i) {
+                CalcResult r = c.scalar(a[i], b[i]);
+                out[i] = r.value;
+                failed += !r.ok();
+            }
+        }
+        double scalar_ms = elapsed_ms(start);
+
+        std::size_t vfailed = 0;
+        start = Clock::now();
+        for (std::size_t done = 0; done < total; done += block) {
+            std::size_t n = std::min(block, total - done);
+            vfailed += c.array(a.data(), b.data(), out.data(), n).count();
+        }
+        double array_ms = elapsed_ms(start);
+
+        std::cout << std::left << std::setw(6) << c.name
+                  << " scalar Melem/s=" << std::setw(10) << total / (scalar_ms * 1000.0)
+                  << " array Melem/s=" << std::setw(10) << total / (array_ms * 1000.0)
+                  << " failed=" << failed << "/" << vfailed << std::endl;
+    }
+}
+
+static void bench_vm(std::size_t rows) {
+    const char* formula = "x*x + 2*x*y + y*y + sqrt(x*x + y*y) + log(z + 1, 2) * (3 * 4 - 2) / (x*x + 1)";
+    Expression expr;
+    expr.parse(formula, true);
+    Program program;
+    program.compile(expr);
+
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> num(0.5, 50.0);
+    std::vector<std::vector<double>> columns(expr.variables().size(), std::vector<double>(rows));
+    for (auto& col : columns) {
+        for (double& v : col) v = num(rng);
+    }
+    std::vector<const double*> inputs;
+    for (auto& col : columns) inputs.push_back(col.data());
+    std::vector<double> out(rows), row(columns.size());
+
+    double sum = 0;
+    auto start = Clock::now();
+    for (std::size_t i = 0; i < rows; ++i) {
+        for (std::size_t c = 0; c < columns.size(); ++c) row[c] = columns[c][i];
+        sum += expr.evaluate(row.data()).value;
+    }
+    double tree_ms = elapsed_ms(start);
+
+    start = Clock::now();
+    std::size_t failed = program.run(inputs.data(), rows, out.data()).count();
+    double vm_ms = elapsed_ms(start);
+
+    std::cout << "formula nodes=" << expr.size() << " instructions=" << program.instructions().size() << std::endl;
+    std::cout << std::left
+              << "tree-walk evals/s=" << std::setw(12) << rows / (tree_ms / 1000.0)
+              << " bytecode evals/s=" << std::setw(12) << rows / (vm_ms / 1000.0)
+              << " failed=" << failed << " (checksum " << sum << ")" << std::endl;
+}
+
+struct Request {
+    int op;
+    double a;
+    double b;
+};
+
+// Requests drawn from `distinct` argument tuples with P(rank k) ~ 1/k^s.
+static std::vector<Request> zipf_trace(std::size_t n, std::size_t distinct, double s) {
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> num(1.5, 1000.0);
+    std::uniform_int_distribution<int> op(0, 2);
+    std::vector<Request> keys(distinct);
+    for (Request& r : keys) {
+        r.op = op(rng);
+        r.a = num(rng);
+        r.b = r.op == 1 ? (double)(2 + rng() % 8) : num(rng) / 100.0;
+    }
+
+    std::vector<double> cdf(distinct);
+    double total = 0;
+    for (std::size_t k = 0; k < distinct; ++k) cdf[k] = total += 1.0 / std::pow((double)(k + 1), s);
+
+    std::uniform_real_distribution<double> unit(0.0, total);
+    std::vector<Request> trace(n);
+    for (Request& r : trace) {
+        std::size_t k = std::lower_bound(cdf.begin(), cdf.end(), unit(rng)) - cdf.begin();
+        r = keys[std::min(k, distinct - 1)];
+    }
+    return trace;
+}
+
+static double replay(const std::vector<Request>& trace, std::size_t begin, std::size_t end, MemoCache* memo) {
+    double sum = 0;
+    for (std::size_t i = begin; i < end; ++i) {
+        const Request& r = trace[i];
+        CalcResult res;
+        if (memo) {
+            res = r.op == 0 ? memo->ppow(r.a, r.b) : r.op == 1 ? memo->llog(r.a, r.b) : memo->ssqrt(r.a, r.b);
+        } else {
+            res = r.op == 0 ? ppow(r.a, r.b) : r.op == 1 ? llog(r.a, r.b) : ssqrt(r.a, r.b);
+        }
+        sum += res.value;
+    }
+    return sum;
+}
+
+static void bench_memo(std::size_t n) {
+    std::vector<Request> trace = zipf_trace(n, 100000, 1.1);
+
+    auto start = Clock::now();
+    double sum = replay(trace, 0, n, nullptr);
+    std::cout << "uncached                         ns/request=" << elapsed_ms(start) * 1e6 / n << std::endl;
+
+    for (std::size_t capacity : {1 << 10, 1 << 15})
+    for (unsigned threads : {1u, 4u}) {
+        MemoCache memo(capacity);
+        std::vector<std::thread> pool;
+        start = Clock::now();
+        for (unsigned t = 0; t < threads; ++t) {
+            pool.emplace_back([&, t] { replay(trace, n * t / threads, n * (t + 1) / threads, &memo); });
+        }
+        for (std::thread& th : pool) th.join();
+        double ms = elapsed_ms(start);
+
+        MemoStats st = memo.stats();
+        std::cout << "cached capacity=" << std::setw(6) << capacity << " threads=" << threads
+                  << " ns/request=" << std::setw(10) << ms * 1e6 / n
+                  << " hit rate=" << std::setw(10) << (double)st.hits / (st.hits + st.misses)
+                  << " evictions=" << st.evictions << std::endl;
+    }
+    std::cout << "(checksum " << sum << ")" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    std::string script = make_script(n);
+
+    auto start = Clock::now();
+    Expression expr;
+    std::size_t parsed = 0;
+    std::string_view rest = script;
+    while (!rest.empty()) {
+        std::size_t eol = rest.find('\n');
+        parsed += expr.parse(rest.substr(0, eol));
+        rest.remove_prefix(eol + 1);
+    }
+    report("parse", parsed, elapsed_ms(start));
+
+    std::string out;
+    out.reserve(script.size());
+    start = Clock::now();
+    std::size_t count = evaluate_batch(script, out);
+    report("parse + evaluate", count, elapsed_ms(start));
+
+    bench_checked(n);
+
+    std::size_t elements = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100000000;
+    bench_arrays(elements);
+
+    bench_vm(n * 10);
+
+    bench_memo(n * 4);
+
+    return 0;
+}
@@ -1,191 +1,257 @@
+#include "calculator.hpp"
+#include <cfenv>
 #include <cmath>
-#include <iostream>
-#include <limits>
-#
-
-#define MAX std::numeric_limits<double>::max()
-#define MIN std::numeric_limits<double>::min()
-
-double add(double a, double b) {
-    try {
-        if ((MAX == a && b > 0) || (MAX == b && a > 0))
-            throw std::overflow_error("Double cant contain your number.");
-        if ((MAX - a < b) || (MIN - a > b))
-            throw std::overflow_error("Double cant contain your sum.");
-        return a + b;
-    }
-    catch (const std::exception &e) {
-        std::cout << e.what() << std::endl;
-        return 0;
-    }
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+constexpr int checked_flags = FE_OVERFLOW | FE_DIVBYZERO | FE_INVALID;
+
+// Flags are sticky, so they only need clearing when something left them set.
+// Testing is much cheaper than clearing on glibc/x86.
+void clear_flags() {
+    if (std::fetestexcept(checked_flags)) std::feclearexcept(checked_flags);
 }
 
-double sub(double a, double b) {
-    try {
-        if ((MAX == a && b < 0) || (MAX == b && a < 0))
-            throw std::overflow_error("Double cant contain your number.");
-        if ((a - b) > MAX || (a - b) < MIN)
-            throw std::overflow_error("Double cant contain your result.");
-        return a - b;
-    }
-    catch (const std::exception &e) {
-        std::cout << e.what() << std::endl;
-        return 0;
-    }
+CalcResult fail(CalcError error) {
+    return {0, error};
 }
 
-double mul(double a, double b) {
-    try {
-        if (b != 0 && (a > MAX / b || a < MIN / b))
-            throw std::overflow_error("Double cant contain your result.");
-        return a * b;
-    }
-    catch (const std::exception &e) {
-        std::cout << e.what() << std::endl;
-        return 0;
-    }
+// The volatile store keeps the operation ahead of fetestexcept; the
+// compiler does not otherwise treat the flags as a dependency.
+CalcResult from_flags(volatile double& result) {
+    int raised = std::fetestexcept(checked_flags);
+    if (raised == 0) return {result, CalcError::None};
+    if (raised & FE_INVALID) return fail(CalcError::Domain);
+    if (raised & FE_DIVBYZERO) return fail(CalcError::DivisionByZero);
+    return fail(CalcError::Overflow);
 }
 
-double div(double a, double b) {
-    try {
-        if (b == 0)
-            throw std::logic_error("Divisor cannot be zero.");
-        if (a > MAX / b || a < MIN / b)
-            throw std::overflow_error("Double cant contain your result.");
-        return a / b;
-    }
-    catch (const std::exception &e) {
-        std::cout << e.what() << std::endl;
-        return 0;
+}
+
+const char* message(CalcError error) {
+    switch (error) {
+        case CalcError::None: return "";
+        case CalcError::Overflow: return "Double cant contain your result.";
+        case CalcError::DivisionByZero: return "Divisor cannot be zero.";
+        case CalcError::LogDomain: return "Logarithm undefined for x <= 0.";
+        case CalcError::LogBase: return "Invalid logarithm base.";
+        case CalcError::RootDegree: return "Root degree cannot be zero.";
+        case CalcError::Domain: return "Result is not a real number.";
     }
+    return "Unknown error.";
 }
 
-double ppow(double a, double b) {
-    try {
-        double result = pow(a, b);
+CalcResult add(double a, double b) {
+    clear_flags();
+    volatile double result = a + b;
+    return from_flags(result);
+}
 
-        if (result > MAX || result < MIN)
-            throw std::overflow_error("Double cant contain your result.");
+CalcResult sub(double a, double b) {
+    clear_flags();
+    volatile double result = a - b;
+    return from_flags(result);
+}
 
-        return result;
-    }
-    catch (const std::exception &e) {
-        std::cout << e.what() << std::endl;
-        return 0;
-    }
+CalcResult mul(double a, double b) {
+    clear_flags();
+    volatile double result = a * b;
+    return from_flags(result);
+}
+
+CalcResult div(double a, double b) {
+    if (b == 0) return fail(CalcError::DivisionByZero);
+
+    clear_flags();
+    volatile double result = a / b;
+    return from_flags(result);
 }
 
-double llog(double x, double base = 2.7) {
-    try {
-        if (x <= 0)
-            throw std::domain_error("Logarithm undefined for x <= 0.");
-        if (base <= 0 || base == 1)
-            throw std::domain_error("Invalid logarithm base.");
+CalcResult ppow(double a, double b) {
+    clear_flags();
+    volatile double result = std::pow(a, b);
+    return from_flags(result);
+}
 
-        double result = log(x) / log(base);
+CalcResult llog(double x, double base) {
+    if (x <= 0) return fail(CalcError::LogDomain);
+    if (base <= 0 || base == 1) return fail(CalcError::LogBase);
 
-        if (result > MAX || result < MIN)
-            throw std::overflow_error("Double cant contain your result.");
+    clear_flags();
+    volatile double result = std::log(x) / std::log(base);
+    return from_flags(result);
+}
 
-        return result;
-    }
-    catch (const std::exception &e) {
-        std::cout << e.what() << std::endl;
-        return 0;
-    }
+CalcResult ssqrt(double x, double y) {
+    if (y == 0) return fail(CalcError::RootDegree);
+
+    clear_flags();
+    volatile double result = std::pow(x, 1.0 / y);
+    return from_flags(result);
 }
 
-double ssqrt(double x, double y = 2) {
-    try {
+// ---------- Array operations ----------
+namespace {
+
+#if defined(__AVX__)
+using Vec = __m256d;
+constexpr std::size_t width = 4;
+
+Vec load(const double* p) { return _mm256_loadu_pd(p); }
+void store(double* p, Vec v) { _mm256_storeu_pd(p, v); }
+Vec splat(double x) { return _mm256_set1_pd(x); }
+Vec vadd(Vec a, Vec b) { return _mm256_add_pd(a, b); }
+Vec vsub(Vec a, Vec b) { return _mm256_sub_pd(a, b); }
+Vec vmul(Vec a, Vec b) { return _mm256_mul_pd(a, b); }
+Vec vdiv(Vec a, Vec b) { return _mm256_div_pd(a, b); }
+Vec vand(Vec a, Vec b) { return _mm256_and_pd(a, b); }
+Vec vor(Vec a, Vec b) { return _mm256_or_pd(a, b); }
+Vec vandnot(Vec mask, Vec v) { return _mm256_andnot_pd(mask, v); }
+Vec vabs(Vec v) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), v); }
+Vec lt(Vec a, Vec b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+Vec le(Vec a, Vec b) { return _mm256_cmp_pd(a, b, _CMP_LE_OQ); }
+Vec eq(Vec a, Vec b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+Vec unordered(Vec a) { return _mm256_cmp_pd(a, a, _CMP_UNORD_Q); }
+unsigned bits(Vec mask) { return (unsigned)_mm256_movemask_pd(mask); }
+#elif defined(__SSE2__)
+using Vec = __m128d;
+constexpr std::size_t width = 2;
+
+Vec load(const double* p) { return _mm_loadu_pd(p); }
+void store(double* p, Vec v) { _mm_storeu_pd(p, v); }
+Vec splat(double x) { return _mm_set1_pd(x); }
+Vec vadd(Vec a, Vec b) { return _mm_add_pd(a, b); }
+Vec vsub(Vec a, Vec b) { return _mm_sub_pd(a, b); }
+Vec vmul(Vec a, Vec b) { return _mm_mul_pd(a, b); }
+Vec vdiv(Vec a, Vec b) { return _mm_div_pd(a, b); }
+Vec vand(Vec a, Vec b) { return _mm_and_pd(a, b); }
+Vec vor(Vec a, Vec b) { return _mm_or_pd(a, b); }
+Vec vandnot(Vec mask, Vec v) { return _mm_andnot_pd(mask, v); }
+Vec vabs(Vec v) { return _mm_andnot_pd(_mm_set1_pd(-0.0), v); }
+Vec lt(Vec a, Vec b) { return _mm_cmplt_pd(a, b); }
+Vec le(Vec a, Vec b) { return _mm_cmple_pd(a, b); }
+Vec eq(Vec a, Vec b) { return _mm_cmpeq_pd(a, b); }
+Vec unordered(Vec a) { return _mm_cmpunord_pd(a, a); }
+unsigned bits(Vec mask) { return (unsigned)_mm_movemask_pd(mask); }
+#else
+// One lane; a mask is a double whose value is 1 (true) or 0 (false).
+using Vec = double;
+constexpr std::size_t width = 1;
+
+Vec load(const double* p) { return *p; }
+void store(double* p, Vec v) { *p = v; }
+Vec splat(double x) { return x; }
+Vec vadd(Vec a, Vec b) { return a + b; }
+Vec vsub(Vec a, Vec b) { return a - b; }
+Vec vmul(Vec a, Vec b) { return a * b; }
+Vec vdiv(Vec a, Vec b) { return a / b; }
+Vec vand(Vec a, Vec b) { return (a != 0) && (b != 0); }
+Vec vor(Vec a, Vec b) { return (a != 0) || (b != 0); }
+Vec vandnot(Vec mask, Vec v) { return mask != 0 ? 0 : v; }
+Vec vabs(Vec v) { return std::fabs(v); }
+Vec lt(Vec a, Vec b) { return a < b; }
+Vec le(Vec a, Vec b) { return a <= b; }
+Vec eq(Vec a, Vec b) { return a == b; }
+Vec unordered(Vec a) { return a != a; }
+unsigned bits(Vec mask) { return mask != 0; }
+#endif
+
+Vec finite(Vec v) { return lt(vabs(v), splat(HUGE_VAL)); }
 
-        if (y == 0)
-            throw std::logic_error("Root degree cannot be zero.");
-        double result = pow(x, 1.0 / y);
+// Lane-wise equivalent of the IEEE flag check: a non-finite result from
+// finite inputs (overflow, x/0, 0/0) or a NaN from non-NaN inputs (inf-inf).
+Vec ieee_error(Vec a, Vec b, Vec r) {
+    Vec overflow = vandnot(finite(r), vand(finite(a), finite(b)));
+    Vec invalid = vandnot(vor(unordered(a), unordered(b)), unordered(r));
+    return vor(overflow, invalid);
+}
+
+Vec no_extra(Vec, Vec) { return splat(0); }
 
-        if (result > MAX || result < MIN)
-            throw std::overflow_error("Double cant contain your result.");
+// Runs one vector of lanes at a time, then the tail one element at a time
+// through the scalar compute/extra with the same mask logic.
+template <class Compute, class Extra>
+StatusBitmap run(const double* a, const double* b, double* out, std::size_t n,
+                 Compute compute, Extra extra, double (*scalar)(double, double)) {
+    StatusBitmap status;
+    status.words.assign((n + 63) / 64, 0);
 
-        return result;
+    std::size_t i = 0;
+    for (; i + width <= n; i += width) {
+        Vec va = load(a + i);
+        Vec vb = load(b + i);
+        Vec r = compute(va, vb, out + i);
+        Vec bad = vor(ieee_error(va, vb, r), extra(va, vb));
+        store(out + i, vandnot(bad, r));
+        status.words[i / 64] |= (std::uint64_t)bits(bad) << (i % 64);
     }
-    catch (const std::exception &e) {
-        std::cout << e.what() << std::endl;
-        return 0;
+    for (; i < n; ++i) {
+        double r = scalar(a[i], b[i]);
+        bool bad = (!std::isfinite(r) && std::isfinite(a[i]) && std::isfinite(b[i]))
+                || (std::isnan(r) && !std::isnan(a[i]) && !std::isnan(b[i]))
+                || bits(extra(splat(a[i]), splat(b[i]))) != 0;
+        out[i] = bad ? 0 : r;
+        if (bad) status.words[i / 64] |= std::uint64_t(1) << (i % 64);
     }
+    return status;
+}
+
+// pow/log/root have no vector form here: fill out per element with libm
+// first, then hand the values to the vector check.
+template <class Extra>
+StatusBitmap run_libm(const double* a, const double* b, double* out, std::size_t n,
+                      double (*scalar)(double, double), Extra extra) {
+    for (std::size_t i = 0; i < n; ++i) out[i] = scalar(a[i], b[i]);
+    return run(a, b, out, n, [](Vec, Vec, const double* r) { return load(r); }, extra, scalar);
 }
 
+}
 
-int main() {
-    int choice;
-    double a, b;
-
-    std::cout << "Select operation:\n";
-    std::cout << "1) Addition\n2) Subtraction\n3) Multiplication\n4) Division\n";
-    std::cout << "5) Power\n6) Logarithm\n7) Root\n";
-    std::cout << "Enter your choice: ";
-    std::cin >> choice;
-
-    switch (choice) {
-        case 1:
-            std::cout << "Enter first number: ";
-            std::cin >> a;
-            std::cout << "Enter second number: ";
-            std::cin >> b;
-            
-            std::cout << "Result: " << add(a, b) << std::endl;
-            break;
-            
-            case 2:
-            std::cout << "Enter first number: ";
-            std::cin >> a;
-            std::cout << "Enter second number: ";
-            std::cin >> b;
-            std::cout << "Result: " << sub(a, b) << std::endl;
-            break;
-            
-            case 3:
-            std::cout << "Enter first number: ";
-            std::cin >> a;
-            std::cout << "Enter second number: ";
-            std::cin >> b;
-            std::cout << "Result: " << mul(a, b) << std::endl;
-            break;
-
-        case 4:
-            std::cout << "Enter first number: ";
-            std::cin >> a;
-            std::cout << "Enter second number: ";
-            std::cin >> b;
-            std::cout << "Result: " << div(a, b) << std::endl;
-            break;
-
-        case 5:
-            std::cout << "Enter base: ";
-            std::cin >> a;
-            std::cout << "Enter exponent: ";
-            std::cin >> b;
-            std::cout << "Result: " << ppow(a, b) << std::endl;
-            break;
-
-        case 6:
-            std::cout << "Enter number: ";
-            std::cin >> a;
-            std::cout << "Enter base (default 2.7)";
-            if (!(std::cin >> b)) b = 2.7;
-            std::cout << "Result: " << llog(a, b) << std::endl;
-            break;
-
-        case 7:
-            std::cout << "Enter number: ";
-            std::cin >> a;
-            std::cout << "Enter root degree (default 2):";
-            if (!(std::cin >> b)) b = 2;
-            std::cout << "Result: " << ssqrt(a, b) << std::endl;
-            break;
-
-        default:
-            std::cout << "Invalid choice." << std::endl;
-    }
+std::size_t StatusBitmap::count() const {
+    std::size_t total = 0;
+    for (std::uint64_t w : words) total += __builtin_popcountll(w);
+    return total;
+}
+
+StatusBitmap add(const double* a, const double* b, double* out, std::size_t n) {
+    return run(a, b, out, n, [](Vec x, Vec y, const double*) { return vadd(x, y); }, no_extra,
+               [](double x, double y) { return x + y; });
+}
+
+StatusBitmap sub(const double* a, const double* b, double* out, std::size_t n) {
+    return run(a, b, out, n, [](Vec x, Vec y, const double*) { return vsub(x, y); }, no_extra,
+               [](double x, double y) { return x - y; });
+}
+
+StatusBitmap mul(const double* a, const double* b, double* out, std::size_t n) {
+    return run(a, b, out, n, [](Vec x, Vec y, const double*) { return vmul(x, y); }, no_extra,
+               [](double x, double y) { return x * y; });
+}
+
+StatusBitmap div(const double* a, const double* b, double* out, std::size_t n) {
+    return run(a, b, out, n, [](Vec x, Vec y, const double*) { return vdiv(x, y); },
+               [](Vec, Vec y) { return eq(y, splat(0)); },
+               [](double x, double y) { return x / y; });
+}
 
-    return 0;
+StatusBitmap ppow(const double* a, const double* b, double* out, std::size_t n) {
+    return run_libm(a, b, out, n, [](double x, double y) { return std::pow(x, y); }, no_extra);
 }
 
+StatusBitmap llog(const double* x, const double* base, double* out, std::size_t n) {
+    return run_libm(x, base, out, n, [](double v, double b) { return std::log(v) / std::log(b); },
+                    [](Vec v, Vec b) {
+                        Vec bad_x = le(v, splat(0));
+                        Vec bad_base = vor(le(b, splat(0)), eq(b, splat(1)));
+                        return vor(bad_x, bad_base);
+                    });
+}
+
+StatusBitmap ssqrt(const double* x, const double* y, double* out, std::size_t n) {
+    return run_libm(x, y, out, n, [](double v, double d) { return std::pow(v, 1.0 / d); },
+                    [](Vec, Vec d) { return eq(d, splat(0)); });
+}
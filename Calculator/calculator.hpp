@@ -0,0 +1,54 @@
+#ifndef CALCULATOR_HPP
+#define CALCULATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ---------- Errors ----------
+enum class CalcError { None, Overflow, DivisionByZero, LogDomain, LogBase, RootDegree, Domain };
+
+const char* message(CalcError error);
+
+// Value plus error code; value is 0 whenever error != None.
+struct CalcResult {
+    double value;
+    CalcError error;
+
+    bool ok() const { return error == CalcError::None; }
+};
+
+// ---------- Checked arithmetic ----------
+// Overflow is detected from the IEEE flags raised by the operation itself
+// (FE_OVERFLOW, FE_DIVBYZERO, FE_INVALID). Underflow to a tiny or zero
+// result is not an error.
+CalcResult add(double a, double b);
+CalcResult sub(double a, double b);
+CalcResult mul(double a, double b);
+CalcResult div(double a, double b);
+CalcResult ppow(double a, double b);
+CalcResult llog(double x, double base = 2.7);
+CalcResult ssqrt(double x, double y = 2);
+
+// ---------- Array operations ----------
+// Element-wise versions of the operations above: out[i] = op(a[i], b[i]).
+// Checks are done lane-wise with SIMD compare masks (AVX when compiled with
+// -mavx, SSE2 otherwise) instead of IEEE flags. Failed elements get 0 in out
+// and their bit set in the returned bitmap; nothing is printed. pow, log and
+// root still call libm per element, only their checks are vectorized.
+struct StatusBitmap {
+    std::vector<std::uint64_t> words;
+
+    bool failed(std::size_t i) const { return (words[i / 64] >> (i % 64)) & 1; }
+    std::size_t count() const;
+};
+
+StatusBitmap add(const double* a, const double* b, double* out, std::size_t n);
+StatusBitmap sub(const double* a, const double* b, double* out, std::size_t n);
+StatusBitmap mul(const double* a, const double* b, double* out, std::size_t n);
+StatusBitmap div(const double* a, const double* b, double* out, std::size_t n);
+StatusBitmap ppow(const double* a, const double* b, double* out, std::size_t n);
+StatusBitmap llog(const double* x, const double* base, double* out, std::size_t n);
+StatusBitmap ssqrt(const double* x, const double* y, double* out, std::size_t n);
+
+#endif
@@ -0,0 +1,251 @@
+#include "engine.hpp"
+#include <cctype>
+#include <charconv>
+
+// ---------- Tokenizer ----------
+Token Tokenizer::next() {
+    while (pos < src.size() && std::isspace((unsigned char)src[pos])) ++pos;
+    if (pos == src.size()) return {TokenKind::End, 0, {}};
+
+    std::size_t start = pos;
+    char c = src[pos];
+
+    if (std::isdigit((unsigned char)c) || c == '.') {
+        double value = 0;
+        auto [ptr, ec] = std::from_chars(src.data() + pos, src.data() + src.size(), value);
+        if (ec != std::errc()) {
+            ++pos;
+            return {TokenKind::Invalid, 0, src.substr(start, 1)};
+        }
+        pos = ptr - src.data();
+        return {TokenKind::Number, value, src.substr(start, pos - start)};
+    }
+
+    if (std::isalpha((unsigned char)c) || c == '_') {
+        while (pos < src.size() && (std::isalnum((unsigned char)src[pos]) || src[pos] == '_')) ++pos;
+        return {TokenKind::Ident, 0, src.substr(start, pos - start)};
+    }
+
+    ++pos;
+    TokenKind kind = TokenKind::Invalid;
+    switch (c) {
+        case '+': kind = TokenKind::Plus; break;
+        case '-': kind = TokenKind::Minus; break;
+        case '*': kind = TokenKind::Star; break;
+        case '/': kind = TokenKind::Slash; break;
+        case '^': kind = TokenKind::Caret; break;
+        case '(': kind = TokenKind::LParen; break;
+        case ')': kind = TokenKind::RParen; break;
+        case ',': kind = TokenKind::Comma; break;
+    }
+    return {kind, 0, src.substr(start, 1)};
+}
+
+// ---------- Expression ----------
+namespace {
+
+// Binding powers for infix operators. Right power below left power makes
+// '^' right-associative; unary minus binds between '*' and '^'.
+constexpr int unary_power = 25;
+
+bool infix(TokenKind kind, int& left, int& right, NodeOp& op) {
+    switch (kind) {
+        case TokenKind::Plus:  left = 10; right = 10; op = NodeOp::Add; return true;
+        case TokenKind::Minus: left = 10; right = 10; op = NodeOp::Sub; return true;
+        case TokenKind::Star:  left = 20; right = 20; op = NodeOp::Mul; return true;
+        case TokenKind::Slash: left = 20; right = 20; op = NodeOp::Div; return true;
+        case TokenKind::Caret: left = 30; right = 29; op = NodeOp::Pow; return true;
+        default: return false;
+    }
+}
+
+}
+
+void Expression::advance() {
+    current = lexer->next();
+}
+
+bool Expression::expect(TokenKind kind, const char* what) {
+    if (current.kind != kind) {
+        if (err.empty()) err = std::string("expected ") + what;
+        return false;
+    }
+    advance();
+    return true;
+}
+
+std::int32_t Expression::push(NodeOp op, std::int32_t lhs, std::int32_t rhs, double value) {
+    nodes.push_back({op, lhs, rhs, value});
+    return (std::int32_t)nodes.size() - 1;
+}
+
+std::int32_t Expression::parse_expr(int min_power) {
+    std::int32_t lhs = parse_prefix();
+    if (lhs < 0) return -1;
+
+    int left, right;
+    NodeOp op;
+    while (infix(current.kind, left, right, op) && left > min_power) {
+        advance();
+        std::int32_t rhs = parse_expr(right);
+        if (rhs < 0) return -1;
+        lhs = push(op, lhs, rhs);
+    }
+    return lhs;
+}
+
+std::int32_t Expression::parse_prefix() {
+    Token tok = current;
+    switch (tok.kind) {
+        case TokenKind::Number:
+            advance();
+            return push(NodeOp::Num, -1, -1, tok.value);
+
+        case TokenKind::Minus: {
+            advance();
+            std::int32_t operand = parse_expr(unary_power);
+            if (operand < 0) return -1;
+            return push(NodeOp::Neg, operand, -1);
+        }
+
+        case TokenKind::Plus:
+            advance();
+            return parse_expr(unary_power);
+
+        case TokenKind::LParen: {
+            advance();
+            std::int32_t inner = parse_expr(0);
+            if (inner < 0 || !expect(TokenKind::RParen, "')'")) return -1;
+            return inner;
+        }
+
+        case TokenKind::Ident:
+            advance();
+            if (current.kind == TokenKind::LParen) return parse_call(tok.text);
+            if (allow_vars) {
+                std::size_t slot = 0;
+                while (slot < vars.size() && vars[slot] != tok.text) ++slot;
+                if (slot == vars.size()) vars.emplace_back(tok.text);
+                return push(NodeOp::Var, (std::int32_t)slot, -1);
+            }
+            err = "unknown identifier '" + std::string(tok.text) + "'";
+            return -1;
+
+        case TokenKind::End:
+            err = "unexpected end of expression";
+            return -1;
+
+        default:
+            err = "unexpected '" + std::string(tok.text) + "'";
+            return -1;
+    }
+}
+
+std::int32_t Expression::parse_call(std::string_view name) {
+    advance();
+    std::int32_t first = parse_expr(0);
+    if (first < 0) return -1;
+
+    std::int32_t second = -1;
+    if (current.kind == TokenKind::Comma) {
+        advance();
+        second = parse_expr(0);
+        if (second < 0) return -1;
+    }
+    if (!expect(TokenKind::RParen, "')'")) return -1;
+
+    if (name == "pow" && second >= 0) return push(NodeOp::Pow, first, second);
+    if (name == "root" && second >= 0) return push(NodeOp::Root, first, second);
+    if (name == "sqrt" && second < 0) return push(NodeOp::Root, first, push(NodeOp::Num, -1, -1, 2));
+    if (name == "log") {
+        if (second < 0) second = push(NodeOp::Num, -1, -1, 2.7);
+        return push(NodeOp::Log, first, second);
+    }
+
+    err = "unknown function '" + std::string(name) + "'";
+    return -1;
+}
+
+bool Expression::parse(std::string_view text, bool variables) {
+    nodes.clear();
+    err.clear();
+    vars.clear();
+    allow_vars = variables;
+    root = -1;
+
+    Tokenizer tokens(text);
+    lexer = &tokens;
+    advance();
+    std::int32_t result = parse_expr(0);
+    if (result >= 0 && current.kind != TokenKind::End) {
+        err = "unexpected '" + std::string(current.text) + "'";
+        result = -1;
+    }
+    lexer = nullptr;
+
+    root = result;
+    return root >= 0;
+}
+
+CalcResult Expression::eval(std::int32_t index, const double* values) const {
+    const Node& n = nodes[index];
+    if (n.op == NodeOp::Num) return {n.value, CalcError::None};
+    if (n.op == NodeOp::Var) return {values[n.lhs], CalcError::None};
+
+    CalcResult lhs = eval(n.lhs, values);
+    if (!lhs.ok()) return lhs;
+    if (n.op == NodeOp::Neg) return {-lhs.value, CalcError::None};
+
+    CalcResult rhs = eval(n.rhs, values);
+    if (!rhs.ok()) return rhs;
+
+    switch (n.op) {
+        case NodeOp::Add:  return add(lhs.value, rhs.value);
+        case NodeOp::Sub:  return sub(lhs.value, rhs.value);
+        case NodeOp::Mul:  return mul(lhs.value, rhs.value);
+        case NodeOp::Div:  return div(lhs.value, rhs.value);
+        case NodeOp::Pow:  return ppow(lhs.value, rhs.value);
+        case NodeOp::Log:  return llog(lhs.value, rhs.value);
+        case NodeOp::Root: return ssqrt(lhs.value, rhs.value);
+        default: break;
+    }
+    return {0, CalcError::None};
+}
+
+CalcResult Expression::evaluate(const double* values) const {
+    if (root < 0) return {0, CalcError::None};
+    return eval(root, values);
+}
+
+// ---------- Batch mode ----------
+std::size_t evaluate_batch(std::string_view input, std::string& out) {
+    Expression expr;
+    std::size_t count = 0;
+    char buf[32];
+
+    while (!input.empty()) {
+        std::size_t eol = input.find('\n');
+        std::string_view line = input.substr(0, eol);
+        input.remove_prefix(eol == std::string_view::npos ? input.size() : eol + 1);
+
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (line.find_first_not_of(" \t") == std::string_view::npos) continue;
+
+        if (expr.parse(line)) {
+            CalcResult result = expr.evaluate();
+            if (result.ok()) {
+                auto [ptr, ec] = std::to_chars(buf, buf + sizeof(buf), result.value);
+                out.append(buf, ptr);
+            } else {
+                out += "error: ";
+                out += message(result.error);
+            }
+        } else {
+            out += "error: ";
+            out += expr.error();
+        }
+        out += '\n';
+        ++count;
+    }
+    return count;
+}
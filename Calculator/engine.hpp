@@ -0,0 +1,81 @@
+#ifndef ENGINE_HPP
+#define ENGINE_HPP
+
+#include "calculator.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ---------- Tokenizer ----------
+enum class TokenKind { Number, Ident, Plus, Minus, Star, Slash, Caret, LParen, RParen, Comma, End, Invalid };
+
+struct Token {
+    TokenKind kind;
+    double value;
+    std::string_view text;
+};
+
+class Tokenizer {
+    std::string_view src;
+    std::size_t pos = 0;
+public:
+    explicit Tokenizer(std::string_view text) : src(text) {}
+    Token next();
+};
+
+// ---------- Expression ----------
+// Parsed expression as a flat node array; children are indices into it.
+// Functions: pow(a, b), log(x), log(x, base), sqrt(x), root(x, degree).
+// Var nodes keep their variable slot in lhs.
+enum class NodeOp : std::uint8_t { Num, Neg, Add, Sub, Mul, Div, Pow, Log, Root, Var };
+
+struct Node {
+    NodeOp op;
+    std::int32_t lhs;
+    std::int32_t rhs;
+    double value;
+};
+
+class Expression {
+    std::vector<Node> nodes;
+    std::int32_t root = -1;
+    std::string err;
+    std::vector<std::string> vars;
+    bool allow_vars = false;
+
+    // Pratt parser state, only valid during parse().
+    Tokenizer* lexer = nullptr;
+    Token current{TokenKind::End, 0, {}};
+
+    void advance();
+    bool expect(TokenKind kind, const char* what);
+    std::int32_t push(NodeOp op, std::int32_t lhs, std::int32_t rhs, double value = 0);
+    std::int32_t parse_expr(int min_power);
+    std::int32_t parse_prefix();
+    std::int32_t parse_call(std::string_view name);
+
+    CalcResult eval(std::int32_t index, const double* values) const;
+
+    friend class Program;
+public:
+    // Reuses the node storage, so one Expression can parse many lines.
+    // With variables == true, bare identifiers become variables numbered in
+    // order of first appearance; otherwise they are an error.
+    bool parse(std::string_view text, bool variables = false);
+    // values[i] is the value of variables()[i]. Stops at the first failing
+    // operation and returns its error.
+    CalcResult evaluate(const double* values = nullptr) const;
+
+    const std::string& error() const { return err; }
+    const std::vector<std::string>& variables() const { return vars; }
+    std::size_t size() const { return nodes.size(); }
+};
+
+// ---------- Batch mode ----------
+// Evaluates one expression per line of input and appends one result (or
+// "error: ...") per line to out. Blank lines are skipped. Returns the number
+// of evaluated expressions.
+std::size_t evaluate_batch(std::string_view input, std::string& out);
+
+#endif
@@ -0,0 +1,118 @@
+#include "calculator.hpp"
+#include "engine.hpp"
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+void print_result(CalcResult result) {
+    if (result.ok()) std::cout << "Result: " << result.value << std::endl;
+    else std::cout << message(result.error) << std::endl;
+}
+
+int run_batch(const char* input_path, const char* output_path) {
+    std::ifstream in(input_path, std::ios::binary);
+    if (!in) {
+        std::cout << "Cant open " << input_path << std::endl;
+        return 1;
+    }
+    std::string input((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    std::string out;
+    out.reserve(input.size());
+    evaluate_batch(input, out);
+
+    if (output_path) {
+        std::ofstream file(output_path, std::ios::binary);
+        if (!file) {
+            std::cout << "Cant open " << output_path << std::endl;
+            return 1;
+        }
+        file.write(out.data(), out.size());
+    } else {
+        std::cout.write(out.data(), out.size());
+        std::cout.flush();
+    }
+    return 0;
+}
+
+// Usage:
+//   ./calculator                      interactive, one operation
+//   ./calculator input.txt [out.txt]  batch, one expression per line
+int main(int argc, char** argv) {
+    if (argc > 1) return run_batch(argv[1], argc > 2 ? argv[2] : nullptr);
+
+    int choice;
+    double a, b;
+
+    std::cout << "Select operation:\n";
+    std::cout << "1) Addition\n2) Subtraction\n3) Multiplication\n4) Division\n";
+    std::cout << "5) Power\n6) Logarithm\n7) Root\n";
+    std::cout << "Enter your choice: ";
+    std::cin >> choice;
+
+    switch (choice) {
+        case 1:
+            std::cout << "Enter first number: ";
+            std::cin >> a;
+            std::cout << "Enter second number: ";
+            std::cin >> b;
+            
+            print_result(add(a, b));
+            break;
+            
+            case 2:
+            std::cout << "Enter first number: ";
+            std::cin >> a;
+            std::cout << "Enter second number: ";
+            std::cin >> b;
+            print_result(sub(a, b));
+            break;
+            
+            case 3:
+            std::cout << "Enter first number: ";
+            std::cin >> a;
+            std::cout << "Enter second number: ";
+            std::cin >> b;
+            print_result(mul(a, b));
+            break;
+
+        case 4:
+            std::cout << "Enter first number: ";
+            std::cin >> a;
+            std::cout << "Enter second number: ";
+            std::cin >> b;
+            print_result(div(a, b));
+            break;
+
+        case 5:
+            std::cout << "Enter base: ";
+            std::cin >> a;
+            std::cout << "Enter exponent: ";
+            std::cin >> b;
+            print_result(ppow(a, b));
+            break;
+
+        case 6:
+            std::cout << "Enter number: ";
+            std::cin >> a;
+            std::cout << "Enter base (default 2.7)";
+            if (!(std::cin >> b)) b = 2.7;
+            print_result(llog(a, b));
+            break;
+
+        case 7:
+            std::cout << "Enter number: ";
+            std::cin >> a;
+            std::cout << "Enter root degree (default 2):";
+            if (!(std::cin >> b)) b = 2;
+            print_result(ssqrt(a, b));
+            break;
+
+        default:
+            std::cout << "Invalid choice." << std::endl;
+    }
+
+    return 0;
+}
+
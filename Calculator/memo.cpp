@@ -0,0 +1,153 @@
+#include "memo.hpp"
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+constexpr std::size_t shard_count = 64;
+
+enum : std::uint8_t { OpPow = 1, OpLog, OpRoot };
+
+std::uint64_t bits_of(double x) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return bits;
+}
+
+double from_bits(std::uint64_t bits) {
+    double x;
+    std::memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+
+// splitmix64 finalizer
+std::uint64_t mix(std::uint64_t h) {
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
+// 1 / log(base) for the last few bases seen by this thread.
+double inverse_log(double base) {
+    struct Slot { std::uint64_t bits; double inv; };
+    thread_local Slot slots[8] = {};
+    thread_local unsigned next = 0;
+
+    std::uint64_t key = bits_of(base);
+    for (const Slot& s : slots) {
+        if (s.bits == key && s.inv != 0) return s.inv;
+    }
+    double inv = 1.0 / std::log(base);
+    slots[next++ % 8] = {key, inv};
+    return inv;
+}
+
+}
+
+MemoCache::MemoCache(std::size_t capacity)
+    : sets(new Set[(capacity + ways - 1) / ways == 0 ? 1 : (capacity + ways - 1) / ways]),
+      shards(new Shard[shard_count]),
+      set_count((capacity + ways - 1) / ways == 0 ? 1 : (capacity + ways - 1) / ways) {}
+
+template <class Compute>
+CalcResult MemoCache::lookup(std::uint8_t op, double a, double b, Compute compute) {
+    std::uint64_t ka = bits_of(a), kb = bits_of(b);
+    std::uint64_t h = mix(ka ^ mix(kb + op));
+
+    std::size_t index = h % set_count;
+    Set& set = sets[index];
+    Shard& shard = shards[index % shard_count];
+
+    std::uint32_t before = set.seq.load(std::memory_order_acquire);
+    if ((before & 1) == 0) {
+        for (std::size_t w = 0; w < ways; ++w) {
+            std::uint32_t tag = set.tag[w].load(std::memory_order_relaxed);
+            if ((tag & 0xff) != op || set.a[w].load(std::memory_order_relaxed) != ka
+                || set.b[w].load(std::memory_order_relaxed) != kb) {
+                continue;
+            }
+            std::uint64_t value = set.value[w].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (set.seq.load(std::memory_order_relaxed) != before) break;
+
+            shard.hits.fetch_add(1, std::memory_order_relaxed);
+            return {from_bits(value), (CalcError)(tag >> 8)};
+        }
+    }
+    shard.misses.fetch_add(1, std::memory_order_relaxed);
+
+    // Computed outside the lock; two threads missing on the same key both
+    // compute it and the second insert just refreshes the slot.
+    CalcResult result = compute(a, b);
+
+    std::lock_guard<std::mutex> guard(shard.lock);
+    std::size_t slot = ways;
+    for (std::size_t w = 0; w < ways; ++w) {
+        std::uint32_t tag = set.tag[w].load(std::memory_order_relaxed);
+        if (tag == 0 || ((tag & 0xff) == op && set.a[w].load(std::memory_order_relaxed) == ka
+                         && set.b[w].load(std::memory_order_relaxed) == kb)) {
+            slot = w;
+            break;
+        }
+    }
+    if (slot == ways) {
+        slot = set.victim;
+        set.victim = (std::uint8_t)((slot + 1) % ways);
+        shard.evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Every set belongs to exactly one shard, so the lock makes this the only
+    // writer; readers see an odd counter and back off.
+    std::uint32_t seq = set.seq.load(std::memory_order_relaxed);
+    set.seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    set.a[slot].store(ka, std::memory_order_relaxed);
+    set.b[slot].store(kb, std::memory_order_relaxed);
+    set.value[slot].store(bits_of(result.value), std::memory_order_relaxed);
+    set.tag[slot].store(op | ((std::uint32_t)result.error << 8), std::memory_order_relaxed);
+
+    set.seq.store(seq + 2, std::memory_order_release);
+    return result;
+}
+
+CalcResult MemoCache::ppow(double a, double b) {
+    return lookup(OpPow, a, b, [](double x, double y) { return ::ppow(x, y); });
+}
+
+CalcResult MemoCache::llog(double x, double base) {
+    return lookup(OpLog, x, base, [](double v, double b) -> CalcResult {
+        if (v <= 0) return {0, CalcError::LogDomain};
+        if (b <= 0 || b == 1) return {0, CalcError::LogBase};
+        return {std::log(v) * inverse_log(b), CalcError::None};
+    });
+}
+
+CalcResult MemoCache::ssqrt(double x, double y) {
+    return lookup(OpRoot, x, y, [](double v, double d) { return ::ssqrt(v, d); });
+}
+
+MemoStats MemoCache::stats() const {
+    MemoStats total;
+    for (std::size_t i = 0; i < shard_count; ++i) {
+        total.hits += shards[i].hits.load(std::memory_order_relaxed);
+        total.misses += shards[i].misses.load(std::memory_order_relaxed);
+        total.evictions += shards[i].evictions.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void MemoCache::clear() {
+    for (std::size_t i = 0; i < set_count; ++i) {
+        for (std::size_t w = 0; w < ways; ++w) sets[i].tag[w].store(0, std::memory_order_relaxed);
+        sets[i].victim = 0;
+    }
+    for (std::size_t i = 0; i < shard_count; ++i) {
+        shards[i].hits.store(0, std::memory_order_relaxed);
+        shards[i].misses.store(0, std::memory_order_relaxed);
+        shards[i].evictions.store(0, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef MEMO_HPP
+#define MEMO_HPP
+
+#include "calculator.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+struct MemoStats {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t evictions = 0;
+};
+
+// ---------- MemoCache ----------
+// Optional memoization for ppow, llog and ssqrt, keyed on the exact bits of
+// the arguments. The table is bounded, 4-way set associative, and evicts
+// round-robin within a set. Lookups take no lock: each set has a sequence
+// counter and a reader treats the lookup as a miss if a writer was active.
+// Inserts lock the shard that owns the set (one of 64).
+// llog multiplies by 1/log(base), cached per thread for the last few bases,
+// so a result can differ from plain llog in the last bit.
+class MemoCache {
+    static constexpr std::size_t ways = 4;
+
+    // Fields of the ways side by side, so a lookup touches two cache lines.
+    struct alignas(128) Set {
+        std::atomic<std::uint32_t> seq{0};   // odd while a writer is inside
+        std::uint8_t victim = 0;
+        std::atomic<std::uint32_t> tag[ways] = {};   // op | error << 8; 0 = empty
+        std::atomic<std::uint64_t> a[ways] = {};
+        std::atomic<std::uint64_t> b[ways] = {};
+        std::atomic<std::uint64_t> value[ways] = {};
+    };
+
+    struct alignas(64) Shard {
+        std::mutex lock;
+        std::atomic<std::uint64_t> hits{0};
+        std::atomic<std::uint64_t> misses{0};
+        std::atomic<std::uint64_t> evictions{0};
+    };
+
+    std::unique_ptr<Set[]> sets;
+    std::unique_ptr<Shard[]> shards;
+    std::size_t set_count;
+
+    template <class Compute>
+    CalcResult lookup(std::uint8_t op, double a, double b, Compute compute);
+
+public:
+    // capacity is the total number of cached results, rounded up to whole sets.
+    explicit MemoCache(std::size_t capacity = 1 << 16);
+
+    CalcResult ppow(double a, double b);
+    CalcResult llog(double x, double base = 2.7);
+    CalcResult ssqrt(double x, double y = 2);
+
+    MemoStats stats() const;
+    // Not safe to call while other threads use the cache.
+    void clear();
+};
+
+#endif
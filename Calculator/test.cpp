@@ -0,0 +1,316 @@
+// test.cpp
+// Test harness for the calculator engine (C++17)
+// - Parser: precedence, associativity, unary minus, function calls,
+//   variables, rejection of malformed input and batch mode output.
+// - Bytecode: Program::run against Expression::evaluate row by row, with
+//   folded constants, shared subexpressions and failing rows.
+// - MemoCache: hit, miss and eviction counters, cached error codes and
+//   keys that differ only in the sign of zero.
+// Build:
+//   g++ -std=c++17 -O2 -pthread test.cpp calculator.cpp engine.cpp vm.cpp memo.cpp -o test
+// Run:
+//   ./test
+
+#include "calculator.hpp"
+#include "engine.hpp"
+#include "memo.hpp"
+#include "vm.hpp"
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+struct Counters {
+    int total = 0;
+    int failed = 0;
+};
+
+static void check_true(bool ok, Counters &c, const std::string &what) {
+    ++c.total;
+    if (!ok) {
+        ++c.failed;
+        std::cerr << "FAIL " << what << "\n";
+    }
+}
+
+static bool approx_equal(double a, double b, double eps = 1e-9) {
+    return std::fabs(a - b) <= eps * std::fmax(1.0, std::fabs(b));
+}
+
+// Parses and evaluates text without variables.
+static void check_value(const std::string &text, double expected, Counters &c) {
+    Expression expr;
+    if (!expr.parse(text)) {
+        check_true(false, c, "'" + text + "' did not parse: " + expr.error());
+        return;
+    }
+    CalcResult result = expr.evaluate();
+    check_true(result.ok() && approx_equal(result.value, expected), c,
+               "'" + text + "' = " + std::to_string(result.value) + ", expected " + std::to_string(expected));
+}
+
+static void check_rejected(const std::string &text, const std::string &message, Counters &c) {
+    Expression expr;
+    bool parsed = expr.parse(text);
+    check_true(!parsed && expr.error().find(message) != std::string::npos, c,
+               "'" + text + "' should fail with '" + message + "', got '" + expr.error() + "'");
+}
+
+// ----------------------------- Parser --------------------------------------
+static void check_parser(Counters &c) {
+    // precedence
+    check_value("1 + 2 * 3", 7, c);
+    check_value("(1 + 2) * 3", 9, c);
+    check_value("2 * 3 ^ 2", 18, c);
+    check_value("1 + 8 / 4 - 1", 2, c);
+
+    // associativity: + - * / to the left, ^ to the right
+    check_value("10 - 4 - 3", 3, c);
+    check_value("100 / 10 / 5", 2, c);
+    check_value("2 ^ 3 ^ 2", 512, c);
+    check_value("(2 ^ 3) ^ 2", 64, c);
+
+    // unary minus binds tighter than * but looser than ^
+    check_value("-3 * 2", -6, c);
+    check_value("2 * -3", -6, c);
+    check_value("-2 ^ 2", -4, c);
+    check_value("(-2) ^ 2", 4, c);
+    check_value("2 ^ -1", 0.5, c);
+    check_value("--4", 4, c);
+    check_value("+5 - -5", 10, c);
+
+    // functions
+    check_value("pow(2, 10)", 1024, c);
+    check_value("sqrt(16)", 4, c);
+    check_value("root(27, 3)", 3, c);
+    check_value("log(8, 2)", 3, c);
+    check_value("log(2.7)", 1, c);
+    check_value("sqrt(pow(3, 2) + pow(4, 2)) * 2", 10, c);
+
+    // a failing operation parses and reports its error from evaluate()
+    Expression expr;
+    check_true(expr.parse("1 + 1 / 0"), c, "'1 + 1 / 0' should parse");
+    check_true(expr.evaluate().error == CalcError::DivisionByZero, c, "'1 + 1 / 0' should be a division by zero");
+    check_true(expr.parse("log(-1)") && expr.evaluate().error == CalcError::LogDomain, c,
+               "'log(-1)' should be a log domain error");
+
+    // malformed input
+    check_rejected("", "unexpected end", c);
+    check_rejected("1 +", "unexpected end", c);
+    check_rejected("(1 + 2", "expected ')'", c);
+    check_rejected("1 2", "unexpected '2'", c);
+    check_rejected(")", "unexpected ')'", c);
+    check_rejected("1 $ 2", "unexpected '$'", c);
+    check_rejected("2 * * 3", "unexpected '*'", c);
+    check_rejected("x + 1", "unknown identifier 'x'", c);
+    check_rejected("foo(1)", "unknown function 'foo'", c);
+    check_rejected("pow(2)", "unknown function 'pow'", c);
+    check_rejected("sqrt(4, 2)", "unknown function 'sqrt'", c);
+    check_rejected("pow(2, 3", "expected ')'", c);
+
+    // a failed parse leaves nothing behind for the next one
+    check_true(!expr.parse("1 +") && expr.evaluate().ok() && expr.evaluate().value == 0, c,
+               "failed parse should evaluate to 0");
+    check_true(expr.parse("6 * 7") && expr.error().empty() && expr.evaluate().value == 42, c,
+               "reparse after a failure should clear the error");
+
+    // variables are numbered by first appearance
+    check_true(expr.parse("b * a + b", true), c, "'b * a + b' should parse with variables");
+    check_true(expr.variables() == std::vector<std::string>{"b", "a"}, c, "variables should be [b, a]");
+    double values[] = {3, 5};
+    check_true(expr.evaluate(values).value == 18, c, "'b * a + b' with b=3, a=5 should be 18");
+}
+
+// ----------------------------- Batch mode ----------------------------------
+static void check_batch(Counters &c) {
+    std::string out;
+    std::size_t count = evaluate_batch("1 + 2\n\n  \r\n2 ^ 3 ^ 2\r\n1 / 0\n1 +\n-4", out);
+    check_true(count == 5, c, "batch should evaluate 5 lines, got " + std::to_string(count));
+    std::string expected = std::string("3\n512\nerror: ") + message(CalcError::DivisionByZero)
+                         + "\nerror: unexpected end of expression\n-4\n";
+    check_true(out == expected, c, "batch output '" + out + "', expected '" + expected + "'");
+}
+
+// ----------------------------- Bytecode ------------------------------------
+// Runs text over rows of x, y, z and compares every row with the tree-walking
+// evaluator: same error rows, same values elsewhere.
+static void check_program(const std::string &text, std::size_t expected_instructions, Counters &c) {
+    Expression expr;
+    Program program;
+    if (!expr.parse(text, true) || !program.compile(expr)) {
+        check_true(false, c, "'" + text + "' did not compile: " + expr.error());
+        return;
+    }
+    check_true(program.variables() == expr.variables(), c, "'" + text + "' program variables differ");
+    check_true(program.instructions().size() == expected_instructions, c,
+               "'" + text + "' compiled to " + std::to_string(program.instructions().size())
+               + " instructions, expected " + std::to_string(expected_instructions));
+
+    // More rows than one run() block, with zeros, negatives and huge values.
+    static const double samples[] = {0, 1, -1, 2, 0.5, -3.25, 7, 1e300, -1e300, 4, 1e-300, 10};
+    const std::size_t n = 1100, count = sizeof(samples) / sizeof(samples[0]);
+    std::vector<std::vector<double>> columns(expr.variables().size(), std::vector<double>(n));
+    for (std::size_t v = 0; v < columns.size(); ++v) {
+        for (std::size_t i = 0; i < n; ++i) columns[v][i] = samples[(i / (v * 5 + 1) + v) % count];
+    }
+    std::vector<const double*> pointers;
+    for (const auto &col : columns) pointers.push_back(col.data());
+
+    std::vector<double> out(n, -1);
+    StatusBitmap status = program.run(pointers.data(), n, out.data());
+
+    std::size_t mismatches = 0, failed = 0;
+    std::string first;
+    std::vector<double> row(columns.size());
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t v = 0; v < columns.size(); ++v) row[v] = columns[v][i];
+        CalcResult expected = expr.evaluate(row.data());
+        bool same = expected.ok() ? !status.failed(i) && approx_equal(out[i], expected.value)
+                                  : status.failed(i) && out[i] == 0;
+        if (!expected.ok()) ++failed;
+        if (!same && mismatches++ == 0) {
+            first = "row " + std::to_string(i) + ": run " + std::to_string(out[i])
+                  + (status.failed(i) ? " (failed)" : "") + ", evaluate "
+                  + (expected.ok() ? std::to_string(expected.value) : message(expected.error));
+        }
+    }
+    check_true(mismatches == 0, c, "'" + text + "' differs in " + std::to_string(mismatches) + " rows, first " + first);
+    check_true(status.count() == failed, c, "'" + text + "' failed rows " + std::to_string(status.count())
+               + ", expected " + std::to_string(failed));
+}
+
+static void check_vm(Counters &c) {
+    // plain operations
+    check_program("x + y * z", 5, c);
+    check_program("-x ^ 2 - y / z", 8, c);
+    check_program("pow(x, 2) + sqrt(y) - log(z, 2)", 9, c);
+    check_program("1 / x", 3, c);
+    check_program("x * y * x * y * x * y", 7, c);
+
+    // constant subtrees fold into one Const
+    check_program("x * (2 + 3)", 3, c);
+    check_program("x + pow(2, 10) / sqrt(16) - -1", 5, c);
+    check_program("-(2 * 3) * x", 3, c);
+    check_program("(1 + 2) * (3 + 4)", 1, c);
+
+    // identical subexpressions share a register; + and * match either order
+    check_program("(x + y) * (x + y)", 4, c);
+    check_program("x * y + y * x", 4, c);
+    check_program("sqrt(x * x + y * y) / sqrt(x * x + y * y)", 8, c);
+    check_program("x - y + (y - x)", 5, c);
+    check_program("(x + 1) * (1 + x) + (x + 1)", 5, c);
+
+    // a constant that fails stays in the code and fails every row
+    check_program("x + 1 / 0", 5, c);
+    check_program("x * log(-1)", 5, c);
+
+    // rows that overflow or leave a domain fail on their own
+    check_program("x * x * y", 4, c);
+    check_program("log(x, y) + root(z, x)", 6, c);
+
+    // the result of an empty compile is nothing to run
+    Expression expr;
+    Program program;
+    check_true(!expr.parse("x +", true) && !program.compile(expr) && program.instructions().empty(), c,
+               "compiling a failed parse should fail");
+}
+
+// ----------------------------- MemoCache -----------------------------------
+static bool stats_are(const MemoCache &cache, std::uint64_t hits, std::uint64_t misses, std::uint64_t evictions) {
+    MemoStats s = cache.stats();
+    return s.hits == hits && s.misses == misses && s.evictions == evictions;
+}
+
+static void check_memo(Counters &c) {
+    // One set of four ways, so the fifth key evicts the oldest.
+    MemoCache cache(4);
+    check_true(stats_are(cache, 0, 0, 0), c, "new cache should have empty stats");
+
+    CalcResult first = cache.ppow(2, 10);
+    check_true(first.ok() && first.value == 1024, c, "memo ppow(2, 10) should be 1024");
+    check_true(stats_are(cache, 0, 1, 0), c, "first ppow should miss");
+    CalcResult again = cache.ppow(2, 10);
+    check_true(again.ok() && again.value == 1024, c, "cached ppow(2, 10) should be 1024");
+    check_true(stats_are(cache, 1, 1, 0), c, "repeated ppow should hit");
+
+    // same arguments under another operation are another key
+    check_true(cache.ssqrt(2, 10).value == ssqrt(2, 10).value, c, "memo ssqrt(2, 10) should match ssqrt");
+    check_true(stats_are(cache, 1, 2, 0), c, "ssqrt with ppow's arguments should miss");
+
+    // errors are cached with their code and a zero value
+    CalcResult domain = cache.llog(-1, 2);
+    check_true(domain.error == CalcError::LogDomain && domain.value == 0, c, "memo llog(-1, 2) should be a log domain error");
+    domain = cache.llog(-1, 2);
+    check_true(domain.error == CalcError::LogDomain && domain.value == 0, c, "cached llog(-1, 2) should keep its error");
+    check_true(stats_are(cache, 2, 3, 0), c, "repeated failing llog should hit");
+
+    // the fourth key fills the set
+    CalcResult base = cache.llog(8, 1);
+    check_true(base.error == CalcError::LogBase, c, "memo llog(8, 1) should be a log base error");
+    check_true(cache.llog(8, 1).error == CalcError::LogBase, c, "cached llog(8, 1) should keep its error");
+    check_true(stats_are(cache, 3, 4, 0), c, "four keys should fit one set");
+
+    // the fifth evicts ppow(2, 10), the oldest way, and eviction goes round-robin
+    check_true(cache.ppow(3, 3).value == 27, c, "memo ppow(3, 3) should be 27");
+    check_true(stats_are(cache, 3, 5, 1), c, "fifth key should evict");
+    check_true(cache.ppow(2, 10).value == 1024, c, "evicted ppow(2, 10) should be recomputed");
+    check_true(stats_are(cache, 3, 6, 2), c, "evicted key should miss and evict the next way");
+    check_true(cache.ssqrt(2, 10).value == ssqrt(2, 10).value, c, "evicted ssqrt(2, 10) should be recomputed");
+    check_true(stats_are(cache, 3, 7, 3), c, "eviction should go round-robin");
+    check_true(cache.ppow(3, 3).value == 27 && cache.llog(8, 1).error == CalcError::LogBase, c,
+               "newer keys should still be cached");
+    check_true(stats_are(cache, 5, 7, 3), c, "newer keys should hit");
+
+    // +0 and -0 are different keys and keep their own sign
+    cache.clear();
+    check_true(stats_are(cache, 0, 0, 0), c, "clear should reset stats");
+    CalcResult plus = cache.ppow(0.0, 1);
+    CalcResult minus = cache.ppow(-0.0, 1);
+    check_true(stats_are(cache, 0, 2, 0), c, "ppow(+0, 1) and ppow(-0, 1) should both miss");
+    check_true(plus.ok() && !std::signbit(plus.value), c, "ppow(+0, 1) should be +0");
+    check_true(minus.ok() && std::signbit(minus.value), c, "ppow(-0, 1) should be -0");
+    minus = cache.ppow(-0.0, 1);
+    plus = cache.ppow(0.0, 1);
+    check_true(stats_are(cache, 2, 2, 0), c, "repeated signed zeros should hit");
+    check_true(!std::signbit(plus.value) && std::signbit(minus.value), c, "cached signed zeros should keep their sign");
+    CalcResult inf_plus = cache.ppow(0.0, -1);
+    CalcResult inf_minus = cache.ppow(-0.0, -1);
+    check_true(inf_plus.error == ppow(0.0, -1).error && inf_minus.error == ppow(-0.0, -1).error, c,
+               "ppow(+-0, -1) should match the uncached error");
+
+    // results agree with the uncached operations across a larger table
+    MemoCache big(1024);
+    std::size_t differ = 0;
+    for (int round = 0; round < 2; ++round) {
+        for (int i = -20; i <= 20; ++i) {
+            double x = i * 0.75;
+            CalcResult p = big.ppow(x, 3), r = big.ssqrt(x, 3), l = big.llog(x, 2);
+            CalcResult ep = ppow(x, 3), er = ssqrt(x, 3), el = llog(x, 2);
+            if (p.error != ep.error || p.value != ep.value) ++differ;
+            if (r.error != er.error || r.value != er.value) ++differ;
+            if (l.error != el.error || !approx_equal(l.value, el.value)) ++differ;
+        }
+    }
+    check_true(differ == 0, c, "memo results differ from uncached results in " + std::to_string(differ) + " cases");
+    check_true(stats_are(big, 123, 123, 0), c, "second round over a large table should only hit");
+}
+
+int main() {
+    Counters counters;
+
+    check_parser(counters);
+    check_batch(counters);
+    check_vm(counters);
+    check_memo(counters);
+
+    if (counters.failed == 0) {
+        std::cout << "Test result: PASSED\n";
+        std::cout << "Total checks: " << counters.total << "\n";
+        return 0;
+    } else {
+        std::cout << "Test result: FAILED: " << counters.failed << " failed checks\n";
+        std::cout << "Total checks: " << counters.total << "\n";
+        return 1;
+    }
+}
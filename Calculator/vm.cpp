@@ -0,0 +1,168 @@
+#include "vm.hpp"
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <tuple>
+
+namespace {
+
+// Rows per block in run(); a multiple of 64 keeps status words aligned.
+constexpr std::size_t block_rows = 512;
+
+// Compile-time value: either a folded constant or a register.
+struct Value {
+    bool constant;
+    double number;
+    std::uint32_t reg;
+};
+
+class Compiler {
+    const std::vector<Node>& nodes;
+    std::vector<Instr>& code;
+    std::map<std::tuple<OpCode, std::uint32_t, std::uint32_t, std::uint64_t>, std::uint32_t> seen;
+
+    std::uint32_t emit(OpCode op, std::uint32_t a, std::uint32_t b, double imm = 0) {
+        if (op == OpCode::Add || op == OpCode::Mul) {
+            if (b < a) std::swap(a, b);
+        }
+        std::uint64_t bits;
+        std::memcpy(&bits, &imm, sizeof(bits));
+
+        auto key = std::make_tuple(op, a, b, bits);
+        auto it = seen.find(key);
+        if (it != seen.end()) return it->second;
+
+        std::uint32_t dst = (std::uint32_t)code.size();
+        code.push_back({op, dst, a, b, imm});
+        seen.emplace(key, dst);
+        return dst;
+    }
+
+    std::uint32_t reg(const Value& v) {
+        return v.constant ? emit(OpCode::Const, 0, 0, v.number) : v.reg;
+    }
+
+public:
+    Compiler(const std::vector<Node>& n, std::vector<Instr>& c) : nodes(n), code(c) {}
+
+    Value compile(std::int32_t index) {
+        const Node& n = nodes[index];
+        switch (n.op) {
+            case NodeOp::Num: return {true, n.value, 0};
+            case NodeOp::Var: return {false, 0, emit(OpCode::Load, (std::uint32_t)n.lhs, 0)};
+            case NodeOp::Neg: {
+                Value v = compile(n.lhs);
+                if (v.constant) return {true, -v.number, 0};
+                return {false, 0, emit(OpCode::Neg, v.reg, 0)};
+            }
+            default: break;
+        }
+
+        Value lhs = compile(n.lhs);
+        Value rhs = compile(n.rhs);
+
+        OpCode op = OpCode::Add;
+        CalcResult (*fold)(double, double) = add;
+        switch (n.op) {
+            case NodeOp::Add:  op = OpCode::Add;  fold = add;   break;
+            case NodeOp::Sub:  op = OpCode::Sub;  fold = sub;   break;
+            case NodeOp::Mul:  op = OpCode::Mul;  fold = mul;   break;
+            case NodeOp::Div:  op = OpCode::Div;  fold = div;   break;
+            case NodeOp::Pow:  op = OpCode::Pow;  fold = ppow;  break;
+            case NodeOp::Log:  op = OpCode::Log;  fold = llog;  break;
+            case NodeOp::Root: op = OpCode::Root; fold = ssqrt; break;
+            default: break;
+        }
+
+        // A constant operation that fails (1/0) stays in the code so every
+        // row reports the error, like the tree-walking evaluator.
+        if (lhs.constant && rhs.constant) {
+            CalcResult folded = fold(lhs.number, rhs.number);
+            if (folded.ok()) return {true, folded.value, 0};
+        }
+        return {false, 0, emit(op, reg(lhs), reg(rhs))};
+    }
+
+    std::uint32_t finish(const Value& v) { return reg(v); }
+};
+
+using ArrayOp = StatusBitmap (*)(const double*, const double*, double*, std::size_t);
+
+ArrayOp array_op(OpCode op) {
+    switch (op) {
+        case OpCode::Add:  return add;
+        case OpCode::Sub:  return sub;
+        case OpCode::Mul:  return mul;
+        case OpCode::Div:  return div;
+        case OpCode::Pow:  return ppow;
+        case OpCode::Log:  return llog;
+        case OpCode::Root: return ssqrt;
+        default: return nullptr;
+    }
+}
+
+}
+
+bool Program::compile(const Expression& expr) {
+    code.clear();
+    vars.clear();
+    result = 0;
+    if (expr.root < 0) return false;
+
+    Compiler compiler(expr.nodes, code);
+    result = compiler.finish(compiler.compile(expr.root));
+    vars = expr.vars;
+    return true;
+}
+
+StatusBitmap Program::run(const double* const* columns, std::size_t n, double* out) const {
+    StatusBitmap status;
+    status.words.assign((n + 63) / 64, 0);
+    if (code.empty()) return status;
+
+    std::vector<double> scratch(code.size() * block_rows);
+    std::vector<const double*> regs(code.size());
+
+    for (const Instr& in : code) {
+        if (in.op == OpCode::Const) {
+            double* col = &scratch[in.dst * block_rows];
+            std::fill(col, col + block_rows, in.imm);
+            regs[in.dst] = col;
+        }
+    }
+
+    for (std::size_t base = 0; base < n; base += block_rows) {
+        std::size_t rows = std::min(block_rows, n - base);
+
+        for (const Instr& in : code) {
+            double* dst = &scratch[in.dst * block_rows];
+            switch (in.op) {
+                case OpCode::Const:
+                    break;
+                case OpCode::Load:
+                    regs[in.dst] = columns[in.a] + base;
+                    break;
+                case OpCode::Neg: {
+                    const double* src = regs[in.a];
+                    for (std::size_t i = 0; i < rows; ++i) dst[i] = -src[i];
+                    regs[in.dst] = dst;
+                    break;
+                }
+                default: {
+                    StatusBitmap part = array_op(in.op)(regs[in.a], regs[in.b], dst, rows);
+                    for (std::size_t w = 0; w < part.words.size(); ++w) {
+                        status.words[base / 64 + w] |= part.words[w];
+                    }
+                    regs[in.dst] = dst;
+                    break;
+                }
+            }
+        }
+
+        const double* res = regs[result];
+        for (std::size_t i = 0; i < rows; ++i) {
+            out[base + i] = status.failed(base + i) ? 0 : res[i];
+        }
+    }
+    return status;
+}
@@ -0,0 +1,43 @@
+#ifndef VM_HPP
+#define VM_HPP
+
+#include "calculator.hpp"
+#include "engine.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ---------- Bytecode ----------
+enum class OpCode : std::uint8_t { Const, Load, Neg, Add, Sub, Mul, Div, Pow, Log, Root };
+
+// dst = op(a, b). Load reads input column a; Const writes imm.
+struct Instr {
+    OpCode op;
+    std::uint32_t dst;
+    std::uint32_t a;
+    std::uint32_t b;
+    double imm;
+};
+
+// ---------- Program ----------
+// Register bytecode compiled once from an Expression with variables.
+// Compilation folds constant subtrees and shares identical subexpressions.
+// A register holds one column of a batch, so run() executes each
+// instruction over a block of rows with the array operations.
+class Program {
+    std::vector<Instr> code;
+    std::vector<std::string> vars;
+    std::uint32_t result = 0;
+
+public:
+    bool compile(const Expression& expr);
+
+    // columns[i] holds n values of variables()[i]; out receives n results.
+    // Rows where any operation failed get 0 and their bit set.
+    StatusBitmap run(const double* const* columns, std::size_t n, double* out) const;
+
+    const std::vector<std::string>& variables() const { return vars; }
+    const std::vector<Instr>& instructions() const { return code; }
+};
+
+#endif
@@ -1,49 +1,115 @@
 
 #include "EmployeePayrollSystem.hpp"
+#include <algorithm>
 #include <iostream>
 
 // ---------------- Departament ----------------
 
-int Departament::calculate_total() {
-    int total = 0;
-    for (Employee* e : employees) {
-        total += e->get_salary();
-    }
+std::int64_t Departament::calculate_total() const {
     return total;
 }
 
+std::size_t Departament::size() const {
+    return employees.size();
+}
+
+// Moves the employee here from any other departament.
 void Departament::add_employee(Employee* e) {
+    if (!e || e->departament == this) return;
+    if (e->departament) e->departament->remove_employee(e);
+    e->departament = this;
+    e->departament_index = employees.size();
     employees.push_back(e);
+    total += e->salary;
+}
+
+// The last employee takes the removed one's place.
+bool Departament::remove_employee(Employee* e) {
+    if (!e || e->departament != this) {
+        std::cout << "Employee is not in this departament!" << std::endl;
+        return false;
+    }
+    Employee* last = employees.back();
+    employees[e->departament_index] = last;
+    last->departament_index = e->departament_index;
+    employees.pop_back();
+    total -= e->salary;
+    e->departament = nullptr;
+    return true;
+}
+
+Departament::~Departament() {
+    for (Employee* e : employees) e->departament = nullptr;
 }
 
 
 // ---------------- Employee ----------------
 
 Employee::Employee(std::string _name, int _projects, int _exp, Role _role)
-    : name(_name), projects(_projects), exp(_exp), role(_role), salary(0) {}
+    : name(_name), id(IdAllocator::next()), projects(_projects), exp(_exp), role(_role), salary(0) {}
 
 void Employee::print_info() {
-    std::cout << "Name: " << name << std::endl;
-    std::cout << "Years worked: " << exp << std::endl;
-    std::cout << "Projects: " << projects << std::endl;
+    std::cout << "Name: " << name << '\n';
+    std::cout << "Years worked: " << exp << '\n';
+    std::cout << "Projects: " << projects << '\n';
 
     switch (role) {
-        case Role::Intern: std::cout << "Role: Intern." << std::endl; break;
-        case Role::Junior: std::cout << "Role: Junior." << std::endl; break;
-        case Role::Middle: std::cout << "Role: Middle." << std::endl; break;
-        case Role::Senior: std::cout << "Role: Senior." << std::endl; break;
-        default: std::cout << "Unknown role." << std::endl; break;
+        case Role::Intern: std::cout << "Role: Intern." << '\n'; break;
+        case Role::Junior: std::cout << "Role: Junior." << '\n'; break;
+        case Role::Middle: std::cout << "Role: Middle." << '\n'; break;
+        case Role::Senior: std::cout << "Role: Senior." << '\n'; break;
+        default: std::cout << "Unknown role." << '\n'; break;
     }
 }
+Employee::~Employee() {
+    if (departament) departament->remove_employee(this);
+}
+
+void Employee::set_salary(int value) {
+    if (departament && !departament->in_payroll) departament->total += std::int64_t(value) - salary;
+    salary = value;
+}
+
 void Employee::calculate_salary() {
-    salary = 0;
+    set_salary(0);
 }
 std::string Employee::get_name() const { return name; }
-int Employee::get_id() const { return id; }
+std::uint64_t Employee::get_id() const { return id; }
 int Employee::get_projects() const { return projects; }
 int Employee::get_exp() const { return exp; }
 int Employee::get_salary() const { return salary; }
 Role Employee::get_role() const { return role; }
+Departament* Employee::get_departament() const { return departament; }
+Employee* Employee::get_manager() const { return nullptr; }
+std::size_t Employee::get_reports() const { return 0; }
+void Employee::set_projects(int _projects) { projects = _projects; }
+void Employee::set_exp(int _exp) { exp = _exp; }
+
+static const char* role_name(Role role) {
+    switch (role) {
+        case Role::Intern: return "Intern";
+        case Role::Junior: return "Junior";
+        case Role::Middle: return "Middle";
+        case Role::Senior: return "Senior";
+        default: return "Unknown";
+    }
+}
+
+void Employee::report_info(ReportWriter& out) const {
+    out.field("id", id);
+    out.field("name", name);
+    out.field("role", role_name(role));
+    out.field("exp", exp);
+    out.field("projects", projects);
+    out.field("salary", salary);
+    report_relations(out);
+}
+
+void Employee::report_relations(ReportWriter& out) const {
+    out.none("mentor");
+    out.none("team_lead");
+    out.none("subordinates");
+}
 
 
 
@@ -54,14 +120,22 @@ Intern::Intern(std::string _name, int _projects, int _exp, Role _role, Employee*
 
 void Intern::print_info() {
     Employee::print_info();
-    std::cout << "Mentor: " << mentor->get_name() << std::endl;
-    std::cout << "Salary: " << salary << std::endl;
+    std::cout << "Mentor: " << mentor->get_name() << '\n';
+    std::cout << "Salary: " << salary << '\n';
+}
+
+void Intern::report_relations(ReportWriter& out) const {
+    if (mentor) out.field("mentor", mentor->get_name()); else out.none("mentor");
+    out.none("team_lead");
+    out.none("subordinates");
 }
 
 void Intern::calculate_salary() {
-    salary = 250000;
+    set_salary(250000);
 }
 
+Employee* Intern::get_manager() const { return mentor; }
+
 
 // ---------------- Junior ----------------
 
@@ -70,14 +144,22 @@ Junior::Junior(std::string _name, int _projects, int _exp, Role _role, Employee*
 
 void Junior::print_info() {
     Employee::print_info();
-    std::cout << "Team lead: " << team_lead->get_name() << std::endl;
-    std::cout << "Salary: " << salary << std::endl;
+    std::cout << "Team lead: " << team_lead->get_name() << '\n';
+    std::cout << "Salary: " << salary << '\n';
+}
+
+void Junior::report_relations(ReportWriter& out) const {
+    out.none("mentor");
+    if (team_lead) out.field("team_lead", team_lead->get_name()); else out.none("team_lead");
+    out.none("subordinates");
 }
 
 void Junior::calculate_salary() {
-    salary = projects * 100000;
+    set_salary(projects * 100000);
 }
 
+Employee* Junior::get_manager() const { return team_lead; }
+
 
 // ---------------- Middle ----------------
 
@@ -86,14 +168,22 @@ Middle::Middle(std::string _name, int _projects, int _exp, Role _role, Employee*
 
 void Middle::print_info() {
     Employee::print_info();
-    std::cout << "Team lead: " << team_lead->get_name() << std::endl;
-    std::cout << "Salary: " << salary << std::endl;
+    std::cout << "Team lead: " << team_lead->get_name() << '\n';
+    std::cout << "Salary: " << salary << '\n';
+}
+
+void Middle::report_relations(ReportWriter& out) const {
+    out.none("mentor");
+    if (team_lead) out.field("team_lead", team_lead->get_name()); else out.none("team_lead");
+    out.none("subordinates");
 }
 
 void Middle::calculate_salary() {
-    salary = (exp * 50000) + (projects * 150000);
+    set_salary((exp * 50000) + (projects * 150000));
 }
 
+Employee* Middle::get_manager() const { return team_lead; }
+
 
 // ---------------- Senior ----------------
 
@@ -102,13 +192,103 @@ Senior::Senior(std::string _name, int _projects, int _exp, Role _role, std::vect
 
 void Senior::print_info() {
     Employee::print_info();
-    std::cout << "Subordinates: " << std::endl;
+    std::cout << "Subordinates: " << '\n';
     for (Employee* e : subord) {
-        std::cout << " - " << e->get_name() << std::endl;
+        std::cout << " - " << e->get_name() << '\n';
     }
-    std::cout << "Salary: " << salary << std::endl;
+    std::cout << "Salary: " << salary << '\n';
+}
+
+void Senior::report_relations(ReportWriter& out) const {
+    out.none("mentor");
+    out.none("team_lead");
+    std::string names;
+    for (Employee* e : subord) {
+        if (!names.empty()) names += ' ';
+        names += e->get_name();
+    }
+    out.field("subordinates", names);
 }
 
 void Senior::calculate_salary() {
-    salary = (subord.size() * 100000) + (exp * 150000) + (projects * 500000);
+    set_salary((subord.size() * 100000) + (exp * 150000) + (projects * 500000));
+}
+
+std::size_t Senior::get_reports() const { return subord.size(); }
+
+
+// ---------------- Payroll ----------------
+
+Payroll::Payroll(unsigned threads) : workers(threads), scratch(workers.size()) {}
+
+std::int64_t Payroll::run(const std::vector<Departament*>& departaments, unsigned threads) {
+    Payroll payroll(threads);
+    return payroll.run(departaments);
+}
+
+std::int64_t Payroll::run(const std::vector<Departament*>& departaments) {
+    struct Chunk {
+        std::size_t departament;
+        std::size_t begin;
+        std::size_t end;
+    };
+    // A departament listed twice is run once.
+    std::vector<Chunk> chunks;
+    std::vector<bool> skip(departaments.size());
+    for (std::size_t d = 0; d < departaments.size(); ++d) {
+        skip[d] = !departaments[d] || departaments[d]->in_payroll;
+        if (skip[d]) continue;
+        std::size_t n = departaments[d]->employees.size();
+        for (std::size_t begin = 0; begin < n; begin += chunk_size)
+            chunks.push_back(Chunk{d, begin, std::min(begin + chunk_size, n)});
+        departaments[d]->in_payroll = true;
+    }
+
+    // One row of lines per thread, a departament's total in each row.
+    const std::size_t lines = (departaments.size() + 7) / 8;
+    sums.assign(lines * workers.size(), Line{});
+
+    workers.run(chunks.size(), [&](std::size_t c, unsigned self) {
+        const Chunk& chunk = chunks[c];
+        const std::vector<Employee*>& employees = departaments[chunk.departament]->employees;
+        std::vector<Employee*>& ordered = scratch[self];
+        ordered.resize(chunk.end - chunk.begin);
+
+        std::size_t starts[5] = {};
+        for (std::size_t i = chunk.begin; i < chunk.end; ++i)
+            ++starts[static_cast<std::size_t>(employees[i]->get_role()) + 1];
+        for (std::size_t r = 1; r < 5; ++r) starts[r] += starts[r - 1];
+        for (std::size_t i = chunk.begin; i < chunk.end; ++i)
+            ordered[starts[static_cast<std::size_t>(employees[i]->get_role())]++] = employees[i];
+
+        std::int64_t total = 0;
+        for (Employee* e : ordered) {
+            e->calculate_salary();
+            total += e->get_salary();
+        }
+        sums[self * lines + chunk.departament / 8].totals[chunk.departament % 8] += total;
+    });
+
+    std::int64_t all = 0;
+    for (std::size_t d = 0; d < departaments.size(); ++d) {
+        if (skip[d]) continue;
+        std::int64_t total = 0;
+        for (unsigned t = 0; t < workers.size(); ++t) total += sums[t * lines + d / 8].totals[d % 8];
+        departaments[d]->total = total;
+        departaments[d]->in_payroll = false;
+        all += total;
+    }
+    return all;
+}
+
+
+// ---------------- Report ----------------
+
+void report_employees(ReportWriter& out, const std::vector<Employee*>& employees) {
+    out.columns({"id", "name", "role", "exp", "projects", "salary", "mentor", "team_lead", "subordinates"});
+    for (const Employee* e : employees) {
+        out.beginRecord();
+        e->report_info(out);
+        out.endRecord();
+    }
 }
@@ -0,0 +1,423 @@
+#include "EmployeeImport.hpp"
+#include <charconv>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <unordered_map>
+#include "../WorkStealingPool/WorkStealingPool.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+enum Column { Id, Name, RoleColumn, Exp, Projects, Mentor, TeamLead, Subordinates, ColumnCount };
+
+const char* const column_names[ColumnCount] = {
+    "id", "name", "role", "exp", "projects", "mentor", "team_lead", "subordinates"};
+
+const std::size_t absent = static_cast<std::size_t>(-1);
+const std::uint32_t none = 0xffffffff;
+
+// Objects follow each other in the arena, so every size must keep the next
+// one aligned.
+static_assert(sizeof(Intern) % alignof(Senior) == 0 && sizeof(Junior) % alignof(Senior) == 0 &&
+              sizeof(Middle) % alignof(Senior) == 0 && sizeof(Senior) % alignof(Senior) == 0 &&
+              alignof(Senior) <= alignof(std::max_align_t), "arena slots would be misaligned");
+
+// A whole file mapped read-only.
+class MappedFile {
+    const char* data = nullptr;
+    std::size_t length = 0;
+public:
+    ~MappedFile() {
+        if (data) munmap(const_cast<char*>(data), length);
+    }
+
+    bool open(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::cout << "Cannot open " << path << std::endl;
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            std::cout << "Cannot read " << path << std::endl;
+            ::close(fd);
+            return false;
+        }
+        void* map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED) {
+            std::cout << "Cannot map " << path << std::endl;
+            return false;
+        }
+        data = static_cast<const char*>(map);
+        length = static_cast<std::size_t>(st.st_size);
+        madvise(map, length, MADV_SEQUENTIAL);
+        return true;
+    }
+
+    const char* begin() const { return data; }
+    const char* end() const { return data + length; }
+};
+
+struct Field {
+    std::string_view text;
+    bool escaped = false;  // quoted, with "" for each quote
+};
+
+// A parsed row; name points into the mapped file.
+struct Row {
+    std::uint64_t id = 0;
+    std::uint64_t mentor = 0;
+    std::uint64_t team_lead = 0;
+    std::string_view name;
+    std::uint32_t subordinates = 0;  // first in Chunk::subordinates
+    std::uint32_t subordinate_count = 0;
+    int exp = 0;
+    int projects = 0;
+    Role role = Role::Intern;
+    bool escaped = false;
+};
+
+struct Chunk {
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    std::vector<Row> rows;
+    std::vector<std::uint64_t> subordinates;
+    std::size_t first = 0;   // index of its first row in the import
+    std::size_t bytes = 0;   // arena bytes of its employees
+    std::size_t offset = 0;  // where they start in the arena
+    std::size_t skipped = 0;
+    const char* first_bad = nullptr;
+    std::size_t unresolved = 0;
+    std::uint64_t min_id = UINT64_MAX;
+    std::uint64_t max_id = 0;
+};
+
+// Column positions in the file, absent for missing optional ones.
+struct Layout {
+    std::size_t at[ColumnCount];
+    std::size_t width = 0;  // fields a row needs
+};
+
+std::size_t object_size(Role role) {
+    switch (role) {
+        case Role::Intern: return sizeof(Intern);
+        case Role::Junior: return sizeof(Junior);
+        case Role::Middle: return sizeof(Middle);
+        default:           return sizeof(Senior);
+    }
+}
+
+// Splits a line into fields; false if a quoted field is not closed.
+bool split(const char* p, const char* end, std::vector<Field>& fields) {
+    fields.clear();
+    for (;;) {
+        Field f;
+        if (p < end && *p == '"') {
+            const char* start = ++p;
+            for (;; ++p) {
+                if (p == end) return false;
+                if (*p != '"') continue;
+                if (p + 1 < end && p[1] == '"') {
+                    f.escaped = true;
+                    ++p;
+                    continue;
+                }
+                break;
+            }
+            f.text = std::string_view(start, p - start);
+            ++p;
+            if (p < end && *p != ',') return false;
+        } else {
+            const char* start = p;
+            while (p < end && *p != ',') ++p;
+            f.text = std::string_view(start, p - start);
+        }
+        fields.push_back(f);
+        if (p == end) return true;
+        ++p;
+    }
+}
+
+template <typename T>
+bool number(std::string_view s, T& value) {
+    auto result = std::from_chars(s.data(), s.data() + s.size(), value);
+    return result.ec == std::errc() && result.ptr == s.data() + s.size();
+}
+
+// An empty reference is none, id 0.
+bool reference(const Layout& layout, const std::vector<Field>& fields, Column c, std::uint64_t& id) {
+    id = 0;
+    if (layout.at[c] == absent) return true;
+    std::string_view s = fields[layout.at[c]].text;
+    return s.empty() || (number(s, id) && id != 0);
+}
+
+bool role_of(std::string_view s, Role& role) {
+    if (s == "Intern") role = Role::Intern;
+    else if (s == "Junior") role = Role::Junior;
+    else if (s == "Middle") role = Role::Middle;
+    else if (s == "Senior") role = Role::Senior;
+    else return false;
+    return true;
+}
+
+bool parse_row(const Layout& layout, const std::vector<Field>& fields, Chunk& chunk, Row& row) {
+    if (fields.size() < layout.width) return false;
+    if (!number(fields[layout.at[Id]].text, row.id) || row.id == 0) return false;
+    if (!role_of(fields[layout.at[RoleColumn]].text, row.role)) return false;
+    if (!number(fields[layout.at[Exp]].text, row.exp)) return false;
+    if (!number(fields[layout.at[Projects]].text, row.projects)) return false;
+    if (!reference(layout, fields, Mentor, row.mentor)) return false;
+    if (!reference(layout, fields, TeamLead, row.team_lead)) return false;
+    row.name = fields[layout.at[Name]].text;
+    row.escaped = fields[layout.at[Name]].escaped;
+
+    row.subordinates = static_cast<std::uint32_t>(chunk.subordinates.size());
+    row.subordinate_count = 0;
+    if (layout.at[Subordinates] == absent) return true;
+    std::string_view list = fields[layout.at[Subordinates]].text;
+    for (std::size_t i = 0; i < list.size();) {
+        if (list[i] == ' ') {
+            ++i;
+            continue;
+        }
+        std::size_t j = list.find(' ', i);
+        if (j == std::string_view::npos) j = list.size();
+        std::uint64_t id;
+        if (!number(list.substr(i, j - i), id) || id == 0) {
+            chunk.subordinates.resize(row.subordinates);
+            return false;
+        }
+        chunk.subordinates.push_back(id);
+        ++row.subordinate_count;
+        i = j;
+    }
+    return true;
+}
+
+void parse(const Layout& layout, Chunk& chunk) {
+    std::vector<Field> fields;
+    Row row;
+    for (const char* p = chunk.begin; p < chunk.end;) {
+        const char* eol = static_cast<const char*>(std::memchr(p, '\n', chunk.end - p));
+        if (!eol) eol = chunk.end;
+        const char* line_end = eol > p && eol[-1] == '\r' ? eol - 1 : eol;
+        if (line_end > p) {
+            if (split(p, line_end, fields) && parse_row(layout, fields, chunk, row)) {
+                chunk.rows.push_back(row);
+                chunk.bytes += object_size(row.role);
+                chunk.min_id = std::min(chunk.min_id, row.id);
+                chunk.max_id = std::max(chunk.max_id, row.id);
+            } else {
+                ++chunk.skipped;
+                if (!chunk.first_bad) chunk.first_bad = p;
+            }
+        }
+        p = eol == chunk.end ? chunk.end : eol + 1;
+    }
+}
+
+std::string name_of(const Row& row) {
+    if (!row.escaped) return std::string(row.name);
+    std::string name;
+    name.reserve(row.name.size());
+    for (std::size_t i = 0; i < row.name.size(); ++i) {
+        name += row.name[i];
+        if (row.name[i] == '"') ++i;
+    }
+    return name;
+}
+
+// Export id -> import index: a flat table when the ids are dense enough,
+// a hash map otherwise.
+class IdIndex {
+    std::uint64_t min_id = 0;
+    std::vector<std::uint32_t> flat;
+    std::unordered_map<std::uint64_t, std::uint32_t> sparse;
+    bool dense = false;
+public:
+    // Returns the number of duplicate ids; the first row of an id wins.
+    std::size_t build(const std::vector<Chunk>& chunks, std::size_t rows, std::uint64_t lo, std::uint64_t hi) {
+        std::size_t duplicates = 0;
+        dense = rows && hi - lo < 4 * std::uint64_t(rows) + 1024;
+        min_id = lo;
+        if (dense) flat.assign(hi - lo + 1, none);
+        else sparse.reserve(rows);
+        for (const Chunk& chunk : chunks) {
+            for (std::size_t r = 0; r < chunk.rows.size(); ++r) {
+                std::uint32_t index = static_cast<std::uint32_t>(chunk.first + r);
+                std::uint64_t id = chunk.rows[r].id;
+                if (dense) {
+                    std::uint32_t& slot = flat[id - min_id];
+                    if (slot == none) slot = index;
+                    else ++duplicates;
+                } else if (!sparse.emplace(id, index).second) {
+                    ++duplicates;
+                }
+            }
+        }
+        return duplicates;
+    }
+
+    std::uint32_t find(std::uint64_t id) const {
+        if (dense) return id >= min_id && id - min_id < flat.size() ? flat[id - min_id] : none;
+        auto it = sparse.find(id);
+        return it != sparse.end() ? it->second : none;
+    }
+};
+
+}
+
+EmployeeImport::~EmployeeImport() { clear(); }
+
+// Employees go in reverse, as if they had been declared in file order.
+void EmployeeImport::clear() {
+    for (auto it = imported.rbegin(); it != imported.rend(); ++it) (*it)->~Employee();
+    imported.clear();
+    source_ids.clear();
+    arena.reset();
+    arena_size = 0;
+    skipped_rows = 0;
+    unresolved_refs = 0;
+}
+
+bool EmployeeImport::load(const std::string& path, unsigned threads) {
+    clear();
+    MappedFile file;
+    if (!file.open(path)) return false;
+
+    const char* p = file.begin();
+    if (file.end() - p >= 3 && std::memcmp(p, "\xEF\xBB\xBF", 3) == 0) p += 3;
+    const char* eol = static_cast<const char*>(std::memchr(p, '\n', file.end() - p));
+    const char* body = eol ? eol + 1 : file.end();
+    if (!eol) eol = file.end();
+    if (eol > p && eol[-1] == '\r') --eol;
+
+    std::vector<Field> header;
+    if (!split(p, eol, header)) {
+        std::cout << path << ": unreadable header row" << std::endl;
+        return false;
+    }
+    Layout layout;
+    for (std::size_t c = 0; c < ColumnCount; ++c) {
+        layout.at[c] = absent;
+        for (std::size_t f = 0; f < header.size(); ++f)
+            if (header[f].text == column_names[c]) layout.at[c] = f;
+        if (c <= Projects && layout.at[c] == absent) {
+            std::cout << path << ": no " << column_names[c] << " column" << std::endl;
+            return false;
+        }
+        if (layout.at[c] != absent) layout.width = std::max(layout.width, layout.at[c] + 1);
+    }
+
+    // Chunks end at line ends, several per thread so stealing can even
+    // them out.
+    WorkStealingPool workers(threads);
+    std::size_t pieces = std::size_t(workers.size()) * 4;
+    std::vector<Chunk> chunks;
+    for (std::size_t i = 0; i < pieces && body < file.end(); ++i) {
+        const char* cut = body + (file.end() - body) * (i + 1) / pieces;
+        if (i + 1 == pieces) {
+            cut = file.end();
+        } else if (cut > body) {
+            const char* nl = static_cast<const char*>(std::memchr(cut - 1, '\n', file.end() - (cut - 1)));
+            cut = nl ? nl + 1 : file.end();
+        }
+        if (cut <= body) continue;
+        chunks.emplace_back();
+        chunks.back().begin = body;
+        chunks.back().end = cut;
+        body = cut;
+    }
+    workers.run(chunks.size(), [&](std::size_t c) { parse(layout, chunks[c]); });
+
+    std::size_t rows = 0, bytes = 0;
+    std::uint64_t lo = UINT64_MAX, hi = 0;
+    const char* first_bad = nullptr;
+    for (Chunk& chunk : chunks) {
+        chunk.first = rows;
+        chunk.offset = bytes;
+        rows += chunk.rows.size();
+        bytes += chunk.bytes;
+        lo = std::min(lo, chunk.min_id);
+        hi = std::max(hi, chunk.max_id);
+        skipped_rows += chunk.skipped;
+        if (!first_bad) first_bad = chunk.first_bad;
+    }
+    if (rows >= none) {
+        std::cout << path << ": too many rows" << std::endl;
+        return false;
+    }
+    if (skipped_rows) {
+        std::cout << path << ": skipped " << skipped_rows << " malformed rows, the first at byte "
+                  << first_bad - file.begin() << std::endl;
+    }
+
+    arena.reset(new unsigned char[bytes ? bytes : 1]);
+    arena_size = bytes;
+    imported.resize(rows);
+    source_ids.resize(rows);
+
+    // First pass: every employee, without relations.
+    workers.run(chunks.size(), [&](std::size_t c) {
+        const Chunk& chunk = chunks[c];
+        unsigned char* at = arena.get() + chunk.offset;
+        for (std::size_t r = 0; r < chunk.rows.size(); ++r) {
+            const Row& row = chunk.rows[r];
+            Employee* e;
+            switch (row.role) {
+                case Role::Intern: e = new (at) Intern(name_of(row), row.projects, row.exp, row.role, nullptr); break;
+                case Role::Junior: e = new (at) Junior(name_of(row), row.projects, row.exp, row.role, nullptr); break;
+                case Role::Middle: e = new (at) Middle(name_of(row), row.projects, row.exp, row.role, nullptr); break;
+                default:           e = new (at) Senior(name_of(row), row.projects, row.exp, row.role, {}); break;
+            }
+            at += object_size(row.role);
+            imported[chunk.first + r] = e;
+            source_ids[chunk.first + r] = row.id;
+        }
+    });
+
+    IdIndex index;
+    if (std::size_t duplicates = index.build(chunks, rows, lo, hi))
+        std::cout << path << ": " << duplicates << " rows repeat an earlier id; references go to the first" << std::endl;
+
+    // Second pass: references by id become pointers, then salaries follow.
+    workers.run(chunks.size(), [&](std::size_t c) {
+        Chunk& chunk = chunks[c];
+        auto find = [&](std::uint64_t id) -> Employee* {
+            if (id == 0) return nullptr;
+            std::uint32_t i = index.find(id);
+            if (i != none) return imported[i];
+            ++chunk.unresolved;
+            return nullptr;
+        };
+        for (std::size_t r = 0; r < chunk.rows.size(); ++r) {
+            const Row& row = chunk.rows[r];
+            Employee* e = imported[chunk.first + r];
+            switch (row.role) {
+                case Role::Intern: static_cast<Intern*>(e)->mentor = find(row.mentor); break;
+                case Role::Junior: static_cast<Junior*>(e)->team_lead = find(row.team_lead); break;
+                case Role::Middle: static_cast<Middle*>(e)->team_lead = find(row.team_lead); break;
+                default: {
+                    std::vector<Employee*>& subord = static_cast<Senior*>(e)->subord;
+                    subord.reserve(row.subordinate_count);
+                    for (std::uint32_t s = 0; s < row.subordinate_count; ++s)
+                        if (Employee* sub = find(chunk.subordinates[row.subordinates + s])) subord.push_back(sub);
+                    break;
+                }
+            }
+            e->calculate_salary();
+        }
+    });
+
+    for (const Chunk& chunk : chunks) unresolved_refs += chunk.unresolved;
+    if (unresolved_refs)
+        std::cout << path << ": " << unresolved_refs << " references to unknown ids left empty" << std::endl;
+    return true;
+}
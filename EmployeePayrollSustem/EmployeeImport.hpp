@@ -0,0 +1,53 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "EmployeePayrollSystem.hpp"
+
+// ---------- EmployeeImport ----------
+// Loads an HR export: CSV with a header row naming at least the columns
+// id, name, role, exp and projects. Optional mentor and team_lead columns
+// hold an employee id, and subordinates holds ids separated by spaces.
+// Other columns, such as salary, are ignored; salaries are recalculated.
+// Fields may be quoted as ReportWriter quotes them, but must not span
+// lines.
+//
+// The file is mapped and cut into chunks at line ends, which threads parse
+// in place with from_chars. The employees are then built into one arena
+// in parallel, and a second pass resolves the id references into
+// pointers. Employees get fresh ids; source_id() gives the export's.
+class EmployeeImport {
+public:
+    EmployeeImport() = default;
+    ~EmployeeImport();
+
+    EmployeeImport(const EmployeeImport&) = delete;
+    EmployeeImport& operator=(const EmployeeImport&) = delete;
+
+    // Replaces any earlier import. Returns false, printing why, if the file
+    // cannot be read or lacks a required column. Malformed rows are skipped
+    // and reported.
+    bool load(const std::string& path, unsigned threads = std::thread::hardware_concurrency());
+    void clear();
+
+    // In file order.
+    const std::vector<Employee*>& employees() const { return imported; }
+    std::uint64_t source_id(std::size_t i) const { return source_ids[i]; }
+
+    std::size_t size() const { return imported.size(); }
+    std::size_t skipped() const { return skipped_rows; }
+    std::size_t unresolved() const { return unresolved_refs; }
+    std::size_t arena_bytes() const { return arena_size; }
+
+private:
+    std::unique_ptr<unsigned char[]> arena;
+    std::size_t arena_size = 0;
+    std::vector<Employee*> imported;
+    std::vector<std::uint64_t> source_ids;
+    std::size_t skipped_rows = 0;
+    std::size_t unresolved_refs = 0;
+};
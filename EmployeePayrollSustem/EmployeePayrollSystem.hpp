@@ -2,85 +2,154 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <cstdint>
+#include "../IdAllocator/IdAllocator.hpp"
+#include "../Report/ReportWriter.hpp"
+#include "../WorkStealingPool/WorkStealingPool.hpp"
 
 class Employee;
-
-// ---------- Counter ----------
-class Counter {
-    inline static int id = 0;
-    friend class Employee;
-};
+class Payroll;
+class EmployeeImport;
 
 // ---------- Role ----------
 enum class Role { Intern, Junior, Middle, Senior };
 
 // ---------- Departament ----------
+// Keeps a 64-bit running total of its employees' salaries. Employees report
+// salary changes to their departament, so calculate_total() is O(1).
+// An employee belongs to at most one departament.
 class Departament {
     std::vector<Employee*> employees;
+    std::int64_t total = 0;
+    bool in_payroll = false;
+    friend class Employee;
+    friend class Payroll;
 public:
     Departament() = default;
+    Departament(const Departament&) = delete;
+    Departament& operator=(const Departament&) = delete;
     void add_employee(Employee* e);
-    int calculate_total();
-    ~Departament() = default;
+    bool remove_employee(Employee* e);
+    std::int64_t calculate_total() const;
+    std::size_t size() const;
+    ~Departament();
 };
 
 // ---------- Employee ----------
 class Employee {
 protected:
     std::string name;
-    int id;
+    std::uint64_t id;
     int projects;
     int exp;
     int salary;
     Role role;
+    Departament* departament = nullptr;
+    std::size_t departament_index = 0;
+    void set_salary(int value);
+    friend class Departament;
 public:
     Employee(std::string _name, int _projects, int _exp, Role _role);
+    Employee(const Employee&) = delete;
+    Employee& operator=(const Employee&) = delete;
     virtual void calculate_salary();
     virtual void print_info();
+    void report_info(ReportWriter& out) const;
+    virtual void report_relations(ReportWriter& out) const;
     std::string get_name() const;
-    int get_id() const;
+    std::uint64_t get_id() const;
     int get_projects() const;
     int get_exp() const;
     int get_salary() const;
     Role get_role() const;
-    virtual ~Employee() = default;
+    Departament* get_departament() const;
+    virtual Employee* get_manager() const;
+    virtual std::size_t get_reports() const;
+    void set_projects(int _projects);
+    void set_exp(int _exp);
+    virtual ~Employee();
 };
 
 // ---------- Intern ----------
 class Intern : public Employee {
     Employee* mentor;
+    friend class EmployeeImport;
 public:
     Intern(std::string _name, int _projects, int _exp, Role _role, Employee* _mentor);
     void calculate_salary() override;
     void print_info() override;
+    void report_relations(ReportWriter& out) const override;
+    Employee* get_manager() const override;
 };
 
 // ---------- Junior ----------
 class Junior : public Employee {
     Employee* team_lead;
+    friend class EmployeeImport;
 public:
     Junior(std::string _name, int _projects, int _exp, Role _role, Employee* _team_lead);
     void print_info() override;
+    void report_relations(ReportWriter& out) const override;
     void calculate_salary() override;
+    Employee* get_manager() const override;
     virtual ~Junior() = default;
 };
 
 // ---------- Middle ----------
 class Middle : public Employee {
     Employee* team_lead;
+    friend class EmployeeImport;
 public:
     Middle(std::string _name, int _projects, int _exp, Role _role, Employee* _team_lead);
     void calculate_salary() override;
     void print_info() override;
+    void report_relations(ReportWriter& out) const override;
+    Employee* get_manager() const override;
     virtual ~Middle() = default;
 };
 
 // ---------- Senior ----------
 class Senior : public Employee {
     std::vector<Employee*> subord;
+    friend class EmployeeImport;
 public:
     Senior(std::string _name, int _projects, int _exp, Role _role, std::vector<Employee*> _subord);
     void calculate_salary() override;
     void print_info() override;
+    void report_relations(ReportWriter& out) const override;
+    std::size_t get_reports() const override;
     virtual ~Senior() = default;
 };
+
+// ---------- Payroll ----------
+// Recalculates every salary of a set of departaments on a thread pool.
+// Each departament is cut into chunks of chunk_size employees; a thread
+// orders its chunk by Role before calling calculate_salary(), so
+// consecutive virtual calls go to the same override. Salaries are summed
+// into per-thread, cache-line-padded accumulators, which then become the
+// departaments' totals.
+class Payroll {
+public:
+    static constexpr std::size_t chunk_size = 4096;
+
+    explicit Payroll(unsigned threads = std::thread::hardware_concurrency());
+
+    // Returns the total of all the departaments.
+    std::int64_t run(const std::vector<Departament*>& departaments);
+    static std::int64_t run(const std::vector<Departament*>& departaments, unsigned threads);
+
+    unsigned threads() const { return workers.size(); }
+private:
+    struct alignas(64) Line {
+        std::int64_t totals[8];
+    };
+
+    WorkStealingPool workers;
+    std::vector<Line> sums;
+    std::vector<std::vector<Employee*>> scratch;
+};
+
+// ---------- Report ----------
+// One record per employee: id, name, role, exp, projects, salary, mentor,
+// team_lead, subordinates.
+void report_employees(ReportWriter& out, const std::vector<Employee*>& employees);
@@ -0,0 +1,147 @@
+#include "EmployeeTable.hpp"
+#include "OrgTree.hpp"
+#include <utility>
+
+EmployeeTable::EmployeeTable(const EmployeeTable& other)
+    : id(other.id), role(other.role), projects(other.projects), exp(other.exp),
+      reports(other.reports), salary(other.salary), manager_id(other.manager_id) {}
+
+// The moved-from columns are left empty, so its tree rebuilds without
+// allocating.
+EmployeeTable::EmployeeTable(EmployeeTable&& other) noexcept
+    : id(std::move(other.id)), role(std::move(other.role)), projects(std::move(other.projects)),
+      exp(std::move(other.exp)), reports(std::move(other.reports)), salary(std::move(other.salary)),
+      manager_id(std::move(other.manager_id)) {
+    if (other.attached_tree) other.attached_tree->rebuild();
+}
+
+EmployeeTable& EmployeeTable::operator=(const EmployeeTable& other) {
+    if (this == &other) return *this;
+    id = other.id;
+    role = other.role;
+    projects = other.projects;
+    exp = other.exp;
+    reports = other.reports;
+    salary = other.salary;
+    manager_id = other.manager_id;
+    if (attached_tree) attached_tree->rebuild();
+    return *this;
+}
+
+EmployeeTable& EmployeeTable::operator=(EmployeeTable&& other) {
+    if (this == &other) return *this;
+    id = std::move(other.id);
+    role = std::move(other.role);
+    projects = std::move(other.projects);
+    exp = std::move(other.exp);
+    reports = std::move(other.reports);
+    salary = std::move(other.salary);
+    manager_id = std::move(other.manager_id);
+    if (attached_tree) attached_tree->rebuild();
+    if (other.attached_tree) other.attached_tree->rebuild();
+    return *this;
+}
+
+void EmployeeTable::reserve(std::size_t n) {
+    id.reserve(n);
+    role.reserve(n);
+    projects.reserve(n);
+    exp.reserve(n);
+    reports.reserve(n);
+    salary.reserve(n);
+    manager_id.reserve(n);
+}
+
+std::size_t EmployeeTable::add(std::uint64_t _id, Role _role, int _projects, int _exp, int _reports, std::uint64_t _manager_id) {
+    id.push_back(_id);
+    role.push_back(static_cast<std::uint8_t>(_role));
+    projects.push_back(_projects);
+    exp.push_back(_exp);
+    reports.push_back(_reports);
+    salary.push_back(0);
+    manager_id.push_back(_manager_id);
+    if (attached_tree) attached_tree->added(size() - 1);
+    return size() - 1;
+}
+
+std::size_t EmployeeTable::add(const Employee& e) {
+    Employee* manager = e.get_manager();
+    std::size_t row = add(e.get_id(), e.get_role(), e.get_projects(), e.get_exp(),
+                          static_cast<int>(e.get_reports()), manager ? manager->get_id() : 0);
+    set_salary(row, e.get_salary());
+    return row;
+}
+
+void EmployeeTable::set_salary(std::size_t row, int _salary) {
+    if (attached_tree) attached_tree->salary_changed(row, std::int64_t(_salary) - salary[row]);
+    salary[row] = _salary;
+}
+
+// Refused when the tree would get a cycle.
+bool EmployeeTable::set_manager(std::size_t row, std::uint64_t _manager_id) {
+    if (attached_tree && !attached_tree->move(row, _manager_id)) return false;
+    manager_id[row] = _manager_id;
+    return true;
+}
+
+// The salary rule of each role class, in unsigned arithmetic so it wraps
+// where the int result it mirrors would.
+template <Role R>
+static inline std::uint32_t rule(std::uint32_t projects, std::uint32_t exp, std::uint32_t reports) {
+    if constexpr (R == Role::Intern) return 250000;
+    else if constexpr (R == Role::Junior) return projects * 100000;
+    else if constexpr (R == Role::Middle) return exp * 50000 + projects * 150000;
+    else return reports * 100000 + exp * 150000 + projects * 500000;
+}
+
+template <Role R>
+static inline std::uint32_t masked(std::uint32_t role, std::uint32_t projects, std::uint32_t exp, std::uint32_t reports) {
+    return rule<R>(projects, exp, reports) & -std::uint32_t(role == static_cast<std::uint32_t>(R));
+}
+
+// Every rule runs and the role masks keep one, so there is no branch.
+static inline std::uint32_t salaryOf(std::uint32_t role, std::uint32_t projects, std::uint32_t exp, std::uint32_t reports) {
+    return masked<Role::Intern>(role, projects, exp, reports) | masked<Role::Junior>(role, projects, exp, reports)
+         | masked<Role::Middle>(role, projects, exp, reports) | masked<Role::Senior>(role, projects, exp, reports);
+}
+
+// Like the ZooWorld kernels this runs over fixed 64-row blocks, which GCC
+// vectorizes at -O2 where an open-ended loop would stay scalar. GCC will
+// not widen the 32-bit salaries into a 64-bit sum there, so a block sums
+// their 16-bit halves in 32 bits, which cannot overflow over 64 rows, and
+// counts the negative ones.
+constexpr std::size_t block = 64;
+
+static std::int64_t salaryBlock(const std::uint8_t* __restrict role, const std::int32_t* __restrict projects,
+                                const std::int32_t* __restrict exp, const std::int32_t* __restrict reports,
+                                std::int32_t* __restrict salary) {
+    std::uint32_t low = 0, high = 0, negative = 0;
+    for (std::size_t i = 0; i < block; ++i) {
+        std::uint32_t v = salaryOf(role[i], projects[i], exp[i], reports[i]);
+        salary[i] = static_cast<std::int32_t>(v);
+        low += v & 0xffff;
+        high += v >> 16;
+        negative += v >> 31;
+    }
+    std::uint64_t sum = (std::uint64_t(high) << 16) + low;
+    return static_cast<std::int64_t>(sum - (std::uint64_t(negative) << 32));
+}
+
+std::int64_t EmployeeTable::calculate_salaries() {
+    std::size_t n = size(), i = 0;
+    std::int64_t all = 0;
+    for (; i + block <= n; i += block)
+        all += salaryBlock(role.data() + i, projects.data() + i, exp.data() + i, reports.data() + i, salary.data() + i);
+    for (; i < n; ++i) {
+        salary[i] = static_cast<std::int32_t>(salaryOf(role[i], projects[i], exp[i], reports[i]));
+        all += salary[i];
+    }
+    if (attached_tree) attached_tree->sync_salaries();
+    return all;
+}
+
+std::int64_t EmployeeTable::total() const {
+    std::int64_t all = 0;
+    for (std::int32_t s : salary) all += s;
+    return all;
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "EmployeePayrollSystem.hpp"
+
+class OrgTree;
+
+// ---------- EmployeeTable ----------
+// Employees as parallel columns, one row each, for bulk work over millions
+// of them. The Employee classes stay the object API; add() copies one in.
+// calculate_salaries() applies the role classes' salary rules to every row
+// at once, picking each row's rule by its role column without branching.
+struct EmployeeTable {
+    std::vector<std::uint64_t> id;
+    std::vector<std::uint8_t> role;         // Role
+    std::vector<std::int32_t> projects;
+    std::vector<std::int32_t> exp;
+    std::vector<std::int32_t> reports;      // a Senior's subordinates
+    std::vector<std::int32_t> salary;
+    std::vector<std::uint64_t> manager_id;  // mentor or team lead, 0 if none
+
+    EmployeeTable() = default;
+    // Copies and moves carry the rows, not the attached tree. A tree attached
+    // to a table whose rows are replaced, or moved away, is rebuilt.
+    EmployeeTable(const EmployeeTable& other);
+    EmployeeTable(EmployeeTable&& other) noexcept;
+    EmployeeTable& operator=(const EmployeeTable& other);
+    EmployeeTable& operator=(EmployeeTable&& other);
+
+    std::size_t size() const { return id.size(); }
+    void reserve(std::size_t n);
+
+    // Appends a row with salary 0 and returns its index.
+    std::size_t add(std::uint64_t _id, Role _role, int _projects, int _exp, int _reports = 0, std::uint64_t _manager_id = 0);
+    // Appends a copy of an employee, salary included.
+    std::size_t add(const Employee& e);
+
+    // Single-row changes that keep the attached tree current.
+    void set_salary(std::size_t row, int _salary);
+    bool set_manager(std::size_t row, std::uint64_t _manager_id);
+
+    // Recomputes every row's salary; returns the total.
+    std::int64_t calculate_salaries();
+    std::int64_t total() const;
+
+    // The tree kept current by add, set_salary, set_manager and
+    // calculate_salaries.
+    void attach(OrgTree* tree) { attached_tree = tree; }
+    OrgTree* attached() const { return attached_tree; }
+
+private:
+    OrgTree* attached_tree = nullptr;
+};
@@ -0,0 +1,176 @@
+#include "OrgTree.hpp"
+#include <algorithm>
+#include <iostream>
+
+static void add(OrgTree::Totals& to, const OrgTree::Totals& from) {
+    to.salary += from.salary;
+    to.headcount += from.headcount;
+    for (std::size_t r = 0; r < 4; ++r) to.roles[r] += from.roles[r];
+}
+
+static void subtract(OrgTree::Totals& to, const OrgTree::Totals& from) {
+    to.salary -= from.salary;
+    to.headcount -= from.headcount;
+    for (std::size_t r = 0; r < 4; ++r) to.roles[r] -= from.roles[r];
+}
+
+OrgTree::OrgTree(EmployeeTable& t) : table(t) {
+    rebuild();
+    table.attach(this);
+}
+
+OrgTree::~OrgTree() {
+    if (table.attached() == this) table.attach(nullptr);
+}
+
+std::uint32_t OrgTree::row_of(std::uint64_t id) const {
+    auto it = rows.find(id);
+    return it != rows.end() ? it->second : none;
+}
+
+std::size_t OrgTree::depth(std::size_t row) const {
+    std::size_t d = 0;
+    for (std::uint32_t a = parents[row]; a != none; a = parents[a]) ++d;
+    return d;
+}
+
+bool OrgTree::under(std::uint32_t row, std::uint32_t ancestor) const {
+    for (std::uint32_t a = row; a != none; a = parents[a])
+        if (a == ancestor) return true;
+    return false;
+}
+
+// The row's totals join every ancestor's, from the new parent up.
+void OrgTree::link(std::uint32_t row, std::uint32_t parent) {
+    parents[row] = parent;
+    for (std::uint32_t a = parent; a != none; a = parents[a]) add(totals[a], totals[row]);
+}
+
+void OrgTree::unlink(std::uint32_t row) {
+    for (std::uint32_t a = parents[row]; a != none; a = parents[a]) subtract(totals[a], totals[row]);
+    parents[row] = none;
+}
+
+void OrgTree::added(std::size_t r) {
+    std::uint32_t row = static_cast<std::uint32_t>(r);
+    Totals own;
+    own.salary = table.salary[row];
+    own.headcount = 1;
+    if (table.role[row] < 4) own.roles[table.role[row]] = 1;
+    parents.push_back(none);
+    totals.push_back(own);
+    ordered = false;
+    rows[table.id[row]] = row;
+
+    std::uint64_t manager = table.manager_id[row];
+    std::uint32_t parent = manager ? row_of(manager) : none;
+    if (parent != none && parent != row) link(row, parent);
+    else if (manager && parent == none) waiting[manager].push_back(row);
+
+    auto it = waiting.find(table.id[row]);
+    if (it == waiting.end()) return;
+    for (std::uint32_t child : it->second) {
+        if (under(row, child)) std::cout << "Employee " << table.id[child] << " would manage itself!" << std::endl;
+        else link(child, row);
+    }
+    waiting.erase(it);
+}
+
+void OrgTree::salary_changed(std::size_t row, std::int64_t delta) {
+    for (std::uint32_t a = static_cast<std::uint32_t>(row); a != none; a = parents[a]) totals[a].salary += delta;
+}
+
+bool OrgTree::move(std::size_t r, std::uint64_t manager_id) {
+    std::uint32_t row = static_cast<std::uint32_t>(r);
+    std::uint32_t parent = manager_id ? row_of(manager_id) : none;
+    if (parent != none && under(parent, row)) {
+        std::cout << "Employee " << table.id[row] << " would manage itself!" << std::endl;
+        return false;
+    }
+    std::uint64_t old = table.manager_id[row];
+    if (parents[row] == none && old) {
+        auto it = waiting.find(old);
+        if (it != waiting.end()) {
+            std::vector<std::uint32_t>& list = it->second;
+            list.erase(std::remove(list.begin(), list.end(), row), list.end());
+            if (list.empty()) waiting.erase(it);
+        }
+    }
+    if (parents[row] != none) unlink(row);
+    if (parent != none) link(row, parent);
+    else if (manager_id) waiting[manager_id].push_back(row);
+    ordered = false;
+    return true;
+}
+
+// Rows ordered deepest first, so a row comes before its parent. Depths are
+// found by walking up to the first row with a known depth; a walk that
+// meets itself has found a cycle, which is cut there.
+std::vector<std::uint32_t> OrgTree::bottom_up() {
+    const std::uint32_t unknown = none, walking = none - 1;
+    std::size_t n = parents.size();
+    if (n == 0) return {};
+    std::vector<std::uint32_t> depths(n, unknown);
+    std::vector<std::uint32_t> path;
+    std::uint32_t deepest = 0;
+    for (std::uint32_t r = 0; r < n; ++r) {
+        std::uint32_t a = r;
+        while (a != none && depths[a] == unknown) {
+            depths[a] = walking;
+            path.push_back(a);
+            a = parents[a];
+        }
+        std::uint32_t d = 0;
+        if (a != none && depths[a] == walking) {
+            std::cout << "Employee " << table.id[path.back()] << " would manage itself!" << std::endl;
+            parents[path.back()] = none;
+        } else if (a != none) {
+            d = depths[a] + 1;
+        }
+        for (; !path.empty(); path.pop_back(), ++d) depths[path.back()] = d;
+        deepest = std::max(deepest, depths[r]);
+    }
+
+    std::vector<std::size_t> starts(deepest + 2, 0);
+    for (std::uint32_t d : depths) ++starts[deepest - d + 1];
+    for (std::size_t i = 1; i < starts.size(); ++i) starts[i] += starts[i - 1];
+    std::vector<std::uint32_t> order(n);
+    for (std::uint32_t r = 0; r < n; ++r) order[starts[deepest - depths[r]]++] = r;
+    return order;
+}
+
+// The order only changes with the shape of the tree, so repeated salary
+// recomputes reuse it.
+void OrgTree::sync_salaries() {
+    if (!ordered) {
+        order = bottom_up();
+        ordered = true;
+    }
+    for (std::size_t r = 0; r < totals.size(); ++r) totals[r].salary = table.salary[r];
+    for (std::uint32_t r : order)
+        if (parents[r] != none) totals[parents[r]].salary += totals[r].salary;
+}
+
+void OrgTree::rebuild() {
+    std::size_t n = table.size();
+    rows.clear();
+    waiting.clear();
+    rows.reserve(n);
+    for (std::uint32_t r = 0; r < n; ++r) rows[table.id[r]] = r;
+
+    parents.assign(n, none);
+    totals.assign(n, Totals());
+    for (std::uint32_t r = 0; r < n; ++r) {
+        std::uint64_t manager = table.manager_id[r];
+        std::uint32_t parent = manager ? row_of(manager) : none;
+        if (parent != r) parents[r] = parent;
+        if (manager && parent == none) waiting[manager].push_back(r);
+        totals[r].salary = table.salary[r];
+        totals[r].headcount = 1;
+        if (table.role[r] < 4) totals[r].roles[table.role[r]] = 1;
+    }
+    order = bottom_up();
+    ordered = true;
+    for (std::uint32_t r : order)
+        if (parents[r] != none) add(totals[parents[r]], totals[r]);
+}
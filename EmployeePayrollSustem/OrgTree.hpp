@@ -0,0 +1,71 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "EmployeeTable.hpp"
+
+// ---------- OrgTree ----------
+// The reporting tree of an EmployeeTable, each row under the row of its
+// manager_id. Every row caches the totals of its subtree, so a subtree
+// query is O(1) and a salary change or re-parenting updates the row's
+// ancestors, O(depth). An Euler tour with a Fenwick tree would answer in
+// O(log n) too, but re-parenting would rewrite the tour, O(n).
+// The table keeps the tree current: add, set_salary and set_manager update
+// single rows, and calculate_salaries calls sync_salaries. A row whose
+// manager is not in the table yet is a root until that row is added.
+class OrgTree {
+public:
+    static constexpr std::uint32_t none = 0xffffffff;
+
+    struct Totals {
+        std::int64_t salary = 0;
+        std::uint32_t headcount = 0;
+        std::array<std::uint32_t, 4> roles{};  // by Role
+    };
+
+    // Builds the tree of every row already in the table and attaches to it.
+    explicit OrgTree(EmployeeTable& t);
+    ~OrgTree();
+
+    OrgTree(const OrgTree&) = delete;
+    OrgTree& operator=(const OrgTree&) = delete;
+
+    // The row's own totals plus those of everyone under it.
+    const Totals& subtree(std::size_t row) const { return totals[row]; }
+    std::uint32_t parent(std::size_t row) const { return parents[row]; }
+    std::size_t depth(std::size_t row) const;
+
+    // Row of an employee id, or none.
+    std::uint32_t row_of(std::uint64_t id) const;
+
+    void added(std::size_t row);
+    void salary_changed(std::size_t row, std::int64_t delta);
+
+    // Puts a row under the row of manager_id, or makes it a root for 0 or
+    // an id not in the table. Returns false, changing nothing, if that would
+    // make a cycle.
+    bool move(std::size_t row, std::uint64_t manager_id);
+
+    // Re-reads the salary column. Needed after writing it directly.
+    void sync_salaries();
+
+    // Rebuilds the tree and every total from the table. A manager cycle in
+    // the table is cut, and reported.
+    void rebuild();
+
+private:
+    void link(std::uint32_t row, std::uint32_t parent);
+    void unlink(std::uint32_t row);
+    bool under(std::uint32_t row, std::uint32_t ancestor) const;
+    std::vector<std::uint32_t> bottom_up();
+
+    EmployeeTable& table;
+    std::vector<std::uint32_t> parents;
+    std::vector<Totals> totals;
+    std::vector<std::uint32_t> order;  // bottom_up(), kept until rows are added or moved
+    bool ordered = false;
+    std::unordered_map<std::uint64_t, std::uint32_t> rows;
+    std::unordered_map<std::uint64_t, std::vector<std::uint32_t>> waiting;  // manager id -> rows
+};
@@ -0,0 +1,429 @@
+// bench.cpp
+// Benchmarks for the Payroll system (C++17)
+// - Report: n employees (default 10^6) to a file, the old print_info with
+//   std::endl per field against ReportWriter as text, CSV and JSON Lines.
+// - Totals: a departament of the n employees, after each small update
+//   (100 salary changes, 10 employees leaving and rejoining), the old
+//   int walk over every employee against the running calculate_total().
+// - Payroll: runs/s recalculating 10n employees (default 10^7) of random
+//   roles in 16 departaments, a serial calculate_salary() loop in list
+//   order against Payroll::run on 1 to N threads (default: hardware
+//   threads, at least 4), and an EmployeeTable of the same employees
+//   recomputing every salary with calculate_salaries().
+// - Org tree: a random org of n employees, subtree salary queries as a
+//   recursive walk against OrgTree's cached totals, and the cost of
+//   salary changes, re-parenting and a full recompute with the tree.
+// - Import: a CSV export of 10n employees with mentor, team_lead and
+//   subordinates ids, read line by line with getline and stoi into new
+//   employees and an id map, against EmployeeImport on 1 to N threads.
+// Build:
+//   g++ -std=c++17 -O2 -pthread bench.cpp EmoloyeePayrollSystem.cpp EmployeeTable.cpp OrgTree.cpp EmployeeImport.cpp ../WorkStealingPool/WorkStealingPool.cpp ../Report/ReportWriter.cpp -o bench
+// Run:
+//   ./bench [employees] [max threads]
+
+#include "EmployeePayrollSystem.hpp"
+#include "EmployeeTable.hpp"
+#include "OrgTree.hpp"
+#include "EmployeeImport.hpp"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsed_ms(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Junior::print_info as it was, flushing every line.
+static void legacy_print_info(std::ostream& out, const Employee& e, const Employee& lead) {
+    out << "Name: " << e.get_name() << std::endl;
+    out << "Years worked: " << e.get_exp() << std::endl;
+    out << "Projects: " << e.get_projects() << std::endl;
+    out << "Role: Junior." << std::endl;
+    out << "Team lead: " << lead.get_name() << std::endl;
+    out << "Salary: " << e.get_salary() << std::endl;
+}
+
+// Departament::calculate_total as it was: a walk summing into an int. It
+// wraps like the old one did, minus the signed overflow.
+static int legacy_total(const std::vector<Employee*>& employees) {
+    unsigned total = 0;
+    for (Employee* e : employees) total += e->get_salary();
+    return static_cast<int>(total);
+}
+
+static void bench_totals(const std::vector<Employee*>& employees) {
+    Departament dept;
+    for (Employee* e : employees) dept.add_employee(e);
+    const int rounds = 200;
+    std::size_t n = employees.size();
+    std::uint64_t step = 0;
+    auto update = [&] {
+        for (int k = 0; k < 100; ++k) {
+            Employee* e = employees[(step += 7919) % n];
+            e->set_projects(e->get_projects() % 7 + 1);
+            e->calculate_salary();
+        }
+        for (int k = 0; k < 10; ++k) {
+            Employee* e = employees[(step += 104729) % n];
+            dept.remove_employee(e);
+            dept.add_employee(e);
+        }
+    };
+
+    std::int64_t legacy_sum = 0, sum = 0;
+    double legacy_ms = 0, ms = 0;
+    for (int r = 0; r < rounds; ++r) {
+        update();
+        auto start = Clock::now();
+        legacy_sum += legacy_total(employees);
+        legacy_ms += elapsed_ms(start);
+        start = Clock::now();
+        sum += dept.calculate_total();
+        ms += elapsed_ms(start);
+    }
+    std::int64_t last = 0;
+    for (Employee* e : employees) last += e->get_salary();
+    std::cout << std::left << std::setw(22) << "walk into int" << " us/total=" << std::setw(10) << legacy_ms * 1e3 / rounds
+              << " last=" << legacy_total(employees) << std::endl;
+    std::cout << std::left << std::setw(22) << "running int64 total" << " us/total=" << std::setw(10) << ms * 1e3 / rounds
+              << " last=" << dept.calculate_total() << " (exact " << last << ")" << std::endl;
+    std::cout << "(checksums " << legacy_sum << " / " << sum << ")" << std::endl;
+}
+
+static void bench_payroll(std::size_t n, unsigned max_threads) {
+    Junior lead("Lead", 3, 4, Role::Junior, nullptr);
+    std::vector<std::unique_ptr<Employee>> owned;
+    std::vector<std::unique_ptr<Departament>> depts;
+    std::vector<Departament*> departaments;
+    for (int d = 0; d < 16; ++d) {
+        depts.push_back(std::make_unique<Departament>());
+        departaments.push_back(depts.back().get());
+    }
+    std::mt19937 rng(7);
+    owned.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        std::string name = "e" + std::to_string(i);
+        int projects = rng() % 7, exp = rng() % 11;
+        switch (rng() % 4) {
+            case 0: owned.push_back(std::make_unique<Intern>(name, projects, exp, Role::Intern, &lead)); break;
+            case 1: owned.push_back(std::make_unique<Junior>(name, projects, exp, Role::Junior, &lead)); break;
+            case 2: owned.push_back(std::make_unique<Middle>(name, projects, exp, Role::Middle, &lead)); break;
+            default: owned.push_back(std::make_unique<Senior>(name, projects, exp, Role::Senior, std::vector<Employee*>{&lead})); break;
+        }
+        departaments[i * 16 / n]->add_employee(owned.back().get());
+    }
+
+    const int rounds = 3;
+    std::int64_t serial_total = 0;
+    auto start = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        serial_total = 0;
+        for (const auto& e : owned) {
+            e->calculate_salary();
+            serial_total += e->get_salary();
+        }
+    }
+    double serial_ms = elapsed_ms(start) / rounds;
+    std::cout << std::left << std::setw(22) << "serial, list order" << " runs/s=" << std::setw(10) << 1e3 / serial_ms
+              << " total=" << serial_total << std::endl;
+
+    double one_ms = 0;
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        Payroll payroll(threads);
+        std::int64_t total = 0;
+        start = Clock::now();
+        for (int r = 0; r < rounds; ++r) total = payroll.run(departaments);
+        double ms = elapsed_ms(start) / rounds;
+        if (threads == 1) one_ms = ms;
+        std::cout << "Payroll::run " << std::setw(2) << threads << " threads" << " runs/s=" << std::setw(10) << 1e3 / ms
+                  << " speedup=" << std::setw(6) << one_ms / ms
+                  << (total == serial_total ? " total ok" : " TOTAL MISMATCH") << std::endl;
+    }
+
+    EmployeeTable table;
+    table.reserve(n);
+    for (const auto& e : owned) table.add(*e);
+    std::int64_t table_total = 0;
+    start = Clock::now();
+    for (int r = 0; r < rounds; ++r) table_total = table.calculate_salaries();
+    double table_ms = elapsed_ms(start) / rounds;
+    std::size_t row_bytes = sizeof(std::uint64_t) * 2 + sizeof(std::uint8_t) + sizeof(std::int32_t) * 4;
+    std::cout << std::left << std::setw(22) << "EmployeeTable" << " runs/s=" << std::setw(10) << 1e3 / table_ms
+              << " speedup=" << std::setw(6) << serial_ms / table_ms << " MiB=" << n * row_bytes / double(1 << 20)
+              << (table_total == serial_total ? " total ok" : " TOTAL MISMATCH") << std::endl;
+}
+
+// An HR export of n employees, a quarter of each role. Interns and the
+// others name a random senior, who lists up to three subordinates.
+static std::size_t write_export(const char* path, std::size_t n) {
+    std::FILE* f = std::fopen(path, "wb");
+    if (!f) return 0;
+    const char* roles[] = {"Intern", "Junior", "Middle", "Senior"};
+    const std::uint64_t base = 5000000000ull;
+    std::mt19937_64 rng(5);
+    auto senior = [&]() { return base + (rng() % (n / 4 ? n / 4 : 1)) * 4 + 3; };
+    std::string buf = "id,name,role,exp,projects,salary,mentor,team_lead,subordinates\n";
+    std::size_t bytes = 0;
+    char num[24];
+    auto put = [&](std::uint64_t v) { buf.append(num, std::to_chars(num, num + sizeof num, v).ptr); };
+    for (std::size_t i = 0; i < n; ++i) {
+        std::size_t role = i % 4;
+        put(base + i);
+        buf += ",employee";
+        put(i);
+        buf += ',';
+        buf += roles[role];
+        buf += ',';
+        put(rng() % 11);
+        buf += ',';
+        put(rng() % 7);
+        buf += ",0,";
+        if (role == 0 && i + 1 < n) put(senior());
+        buf += ',';
+        if ((role == 1 || role == 2) && i + 1 < n) put(senior());
+        buf += ',';
+        if (role == 3) {
+            for (std::uint64_t s = rng() % 4; s > 0; --s) {
+                put(base + rng() % n);
+                if (s > 1) buf += ' ';
+            }
+        }
+        buf += '\n';
+        if (buf.size() > (1 << 20)) {
+            bytes += std::fwrite(buf.data(), 1, buf.size(), f);
+            buf.clear();
+        }
+    }
+    bytes += std::fwrite(buf.data(), 1, buf.size(), f);
+    std::fclose(f);
+    return bytes;
+}
+
+// The straightforward importer: getline, a stringstream per line, stoi,
+// one new per employee and a second pass over an unordered_map.
+static std::size_t naive_import(const char* path, std::vector<std::unique_ptr<Employee>>& owned) {
+    struct Refs { std::uint64_t manager; std::vector<std::uint64_t> subordinates; };
+    std::ifstream in(path);
+    std::string line, field;
+    std::getline(in, line);
+    std::unordered_map<std::uint64_t, Employee*> by_id;
+    std::vector<Refs> refs;
+    while (std::getline(in, line)) {
+        std::stringstream ss(line);
+        std::vector<std::string> f;
+        while (std::getline(ss, field, ',')) f.push_back(field);
+        f.resize(9);
+        std::string name = f[1];
+        int exp = std::stoi(f[3]), projects = std::stoi(f[4]);
+        Refs r{0, {}};
+        if (f[2] == "Intern") {
+            owned.push_back(std::make_unique<Intern>(name, projects, exp, Role::Intern, nullptr));
+            if (!f[6].empty()) r.manager = std::stoull(f[6]);
+        } else if (f[2] == "Junior" || f[2] == "Middle") {
+            if (f[2] == "Junior") owned.push_back(std::make_unique<Junior>(name, projects, exp, Role::Junior, nullptr));
+            else owned.push_back(std::make_unique<Middle>(name, projects, exp, Role::Middle, nullptr));
+            if (!f[7].empty()) r.manager = std::stoull(f[7]);
+        } else {
+            std::stringstream ids(f[8]);
+            std::uint64_t id;
+            while (ids >> id) r.subordinates.push_back(id);
+            owned.push_back(std::make_unique<Senior>(name, projects, exp, Role::Senior, std::vector<Employee*>{}));
+        }
+        by_id[std::stoull(f[0])] = owned.back().get();
+        refs.push_back(std::move(r));
+    }
+    // The reference fields are private, so this pass only looks the ids up.
+    std::size_t resolved = 0;
+    for (std::size_t i = 0; i < owned.size(); ++i) {
+        auto it = by_id.find(refs[i].manager);
+        resolved += it != by_id.end();
+        for (std::uint64_t id : refs[i].subordinates) resolved += by_id.count(id);
+        owned[i]->calculate_salary();
+    }
+    return resolved;
+}
+
+static void bench_import(std::size_t n, unsigned max_threads) {
+    const char* path = "payroll_import_bench.csv";
+    std::size_t bytes = write_export(path, n);
+    double mib = bytes / double(1 << 20);
+    std::cout << "export of " << n << " employees, MiB=" << mib << std::endl;
+
+    {
+        std::vector<std::unique_ptr<Employee>> owned;
+        owned.reserve(n);
+        auto start = Clock::now();
+        naive_import(path, owned);
+        double ms = elapsed_ms(start);
+        std::cout << std::left << std::setw(22) << "getline + stoi" << " rows/s=" << std::setw(10) << owned.size() / ms * 1e3
+                  << " MiB/s=" << mib / ms * 1e3 << std::endl;
+    }
+
+    double one_ms = 0;
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        EmployeeImport import;
+        auto start = Clock::now();
+        import.load(path, threads);
+        double ms = elapsed_ms(start);
+        if (threads == 1) one_ms = ms;
+        std::cout << "EmployeeImport " << std::setw(2) << threads << " thr" << " rows/s=" << std::setw(10) << import.size() / ms * 1e3
+                  << " MiB/s=" << std::setw(8) << mib / ms * 1e3 << " speedup=" << std::setw(6) << one_ms / ms
+                  << " arena MiB=" << import.arena_bytes() / double(1 << 20) << std::endl;
+    }
+    std::remove(path);
+}
+
+// "Total salary under this employee" by walking the reports each time.
+static std::int64_t walk_salary(const EmployeeTable& table, const std::vector<std::vector<std::uint32_t>>& reports,
+                                std::uint32_t row) {
+    std::int64_t total = table.salary[row];
+    for (std::uint32_t r : reports[row]) total += walk_salary(table, reports, r);
+    return total;
+}
+
+static void bench_org(std::size_t n) {
+    std::mt19937 rng(3);
+    EmployeeTable table;
+    table.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        std::uint64_t manager = i == 0 ? 0 : table.id[rng() % i];
+        table.add(IdAllocator::next(), static_cast<Role>(rng() % 4), rng() % 7, rng() % 11, rng() % 4, manager);
+    }
+    table.calculate_salaries();
+
+    auto start = Clock::now();
+    OrgTree tree(table);
+    double build_ms = elapsed_ms(start);
+    std::size_t deepest = 0;
+    for (std::size_t r = 0; r < n; r += 97) deepest = std::max(deepest, tree.depth(r));
+    std::cout << "  build ms=" << build_ms << " depth>=" << deepest << std::endl;
+
+    std::vector<std::vector<std::uint32_t>> reports(n);
+    for (std::uint32_t r = 1; r < n; ++r) reports[tree.parent(r)].push_back(r);
+
+    const std::size_t queries = 100000;
+    std::vector<std::uint32_t> picks(queries);
+    for (std::uint32_t& p : picks) p = rng() % n;
+    std::int64_t walked = 0, cached = 0;
+    start = Clock::now();
+    for (std::uint32_t p : picks) walked += walk_salary(table, reports, p);
+    double walk_ns = elapsed_ms(start) * 1e6 / queries;
+    start = Clock::now();
+    for (std::uint32_t p : picks) cached += tree.subtree(p).salary;
+    double cached_ns = elapsed_ms(start) * 1e6 / queries;
+    start = Clock::now();
+    std::int64_t root_walk = walk_salary(table, reports, 0);
+    double root_ms = elapsed_ms(start);
+    std::cout << "  random subtree ns/query: walk=" << walk_ns << " cached=" << cached_ns
+              << (walked == cached ? " (same)" : " (DIFFERENT)") << std::endl;
+    std::cout << "  whole org: walk ms=" << root_ms << " cached=" << tree.subtree(0).salary
+              << (root_walk == tree.subtree(0).salary ? " (same)" : " (DIFFERENT)") << std::endl;
+
+    start = Clock::now();
+    for (std::size_t k = 0; k < queries; ++k) table.set_salary(picks[k], int(picks[k] % 1000) * 1000);
+    double salary_ns = elapsed_ms(start) * 1e6 / queries;
+    std::size_t refused = 0;
+    start = Clock::now();
+    for (std::size_t k = 0; k < queries; ++k)
+        refused += !table.set_manager(1 + rng() % (n - 1), table.id[picks[k]]);
+    double move_ns = elapsed_ms(start) * 1e6 / queries;
+    std::cout << "  set_salary ns=" << salary_ns << " set_manager ns=" << move_ns
+              << " (" << refused << " refused as cycles)" << std::endl;
+
+    // The first sync after the moves orders the tree again; later ones reuse it.
+    start = Clock::now();
+    table.calculate_salaries();
+    double first_ms = elapsed_ms(start);
+    start = Clock::now();
+    table.calculate_salaries();
+    double with_ms = elapsed_ms(start);
+    table.attach(nullptr);
+    start = Clock::now();
+    table.calculate_salaries();
+    double without_ms = elapsed_ms(start);
+    table.attach(&tree);
+    std::cout << "  calculate_salaries ms=" << without_ms << " with tree sync ms=" << with_ms
+              << " (first after moves " << first_ms << ")" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const char* path = "payroll_report_bench.txt";
+
+    Junior lead("Lead", 3, 4, Role::Junior, nullptr);
+    std::vector<std::unique_ptr<Employee>> owned;
+    std::vector<Employee*> employees;
+    owned.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        std::string name = "employee" + std::to_string(i);
+        int projects = i % 7, exp = i % 11;
+        switch (i % 4) {
+            case 0: owned.push_back(std::make_unique<Intern>(name, projects, exp, Role::Intern, &lead)); break;
+            case 1: owned.push_back(std::make_unique<Junior>(name, projects, exp, Role::Junior, &lead)); break;
+            case 2: owned.push_back(std::make_unique<Middle>(name, projects, exp, Role::Middle, &lead)); break;
+            default: owned.push_back(std::make_unique<Senior>(name, projects, exp, Role::Senior, std::vector<Employee*>{&lead})); break;
+        }
+        owned.back()->calculate_salary();
+        employees.push_back(owned.back().get());
+    }
+    std::cout << "report of " << n << " employees" << std::endl;
+
+    {
+        std::ofstream out(path);
+        auto start = Clock::now();
+        for (const Employee* e : employees) legacy_print_info(out, *e, lead);
+        double ms = elapsed_ms(start);
+        std::cout << std::left << std::setw(22) << "print_info + endl" << " ms=" << std::setw(10) << ms
+                  << " MiB=" << out.tellp() / double(1 << 20) << std::endl;
+    }
+
+    const std::pair<const char*, ReportFormat> formats[] = {
+        {"ReportWriter text", ReportFormat::Text},
+        {"ReportWriter CSV", ReportFormat::Csv},
+        {"ReportWriter JSONL", ReportFormat::JsonLines},
+    };
+    for (const auto& f : formats) {
+        std::ofstream out(path);
+        auto start = Clock::now();
+        {
+            ReportWriter writer(out, f.second);
+            report_employees(writer, employees);
+        }
+        double ms = elapsed_ms(start);
+        std::cout << std::left << std::setw(22) << f.first << " ms=" << std::setw(10) << ms
+                  << " MiB=" << out.tellp() / double(1 << 20) << std::endl;
+    }
+    std::remove(path);
+
+    std::cout << "totals of a departament of " << n << " employees" << std::endl;
+    bench_totals(employees);
+
+    unsigned hw = std::thread::hardware_concurrency();
+    unsigned max_threads = argc > 2 ? std::atoi(argv[2]) : std::max(4u, hw);
+    owned.clear();
+    employees.clear();
+    std::cout << "org tree of " << n << " employees" << std::endl;
+    bench_org(n);
+
+    std::cout << "payroll of " << n * 10 << " employees" << std::endl;
+    bench_payroll(n * 10, max_threads);
+
+    std::cout << "import of " << n * 10 << " employees" << std::endl;
+    bench_import(n * 10, max_threads);
+    return 0;
+}
@@ -1,10 +1,20 @@
 // test_main.cpp
 #include "EmployeePayrollSystem.hpp"
+#include "EmployeeTable.hpp"
+#include "OrgTree.hpp"
+#include "EmployeeImport.hpp"
 #include <iostream>
 #include <sstream>
 #include <vector>
 #include <string>
 #include <functional>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+#include <random>
+#include <limits>
 
 using namespace std;
 
@@ -163,17 +173,306 @@ int main() {
     }
 
     // compute expected total
-    int expected_total = 0;
-    for (Employee* e : created) expected_total += e->get_salary();
+    auto sum_of = [](const vector<Employee*>& es) {
+        int64_t sum = 0;
+        for (Employee* e : es) if (e) sum += e->get_salary();
+        return sum;
+    };
+    int64_t expected_total = sum_of(created);
 
-    int dept_total = dept.calculate_total();
+    int64_t dept_total = dept.calculate_total();
     res.add_check(dept_total == expected_total,
                   "Departament total mismatch: expected " + to_string(expected_total) + ", got " + to_string(dept_total));
 
+    // The running total follows salary changes, removals, moves and deletes.
+    for (int i = 0; i < 30; i += 3) {
+        created[i]->set_projects(created[i]->get_projects() + 2);
+        created[i]->set_exp(created[i]->get_exp() + 1);
+        created[i]->calculate_salary();
+    }
+    res.add_check(dept.calculate_total() == sum_of(created), "Departament total stale after salary changes");
+
+    Departament other;
+    other.add_employee(created[4]);
+    other.add_employee(created[7]);
+    res.add_check(created[4]->get_departament() == &other && dept.size() == 28 && other.size() == 2,
+                  "add_employee did not move employees between departaments");
+    res.add_check(other.calculate_total() == created[4]->get_salary() + int64_t(created[7]->get_salary()),
+                  "Departament total wrong after move in");
+    res.add_check(dept.remove_employee(created[10]) && !dept.remove_employee(created[10]),
+                  "remove_employee accepted an employee twice");
+    delete created[11];
+    created[11] = nullptr;
+    vector<Employee*> remaining;
+    for (Employee* e : created)
+        if (e && e->get_departament() == &dept) remaining.push_back(e);
+    res.add_check(dept.size() == remaining.size() && dept.calculate_total() == sum_of(remaining),
+                  "Departament total wrong after remove and delete");
+
+    // 64-bit totals: 10^4 Seniors at 15.5 million each exceed INT_MAX.
+    {
+        Departament big;
+        vector<Senior*> seniors;
+        for (int i = 0; i < 10000; ++i) {
+            seniors.push_back(new Senior("Big_" + to_string(i), 30, 3, Role::Senior, {}));
+            big.add_employee(seniors.back());
+            seniors.back()->calculate_salary();
+        }
+        res.add_check(big.calculate_total() == int64_t(10000) * 15450000,
+                      "Departament total overflowed: " + to_string(big.calculate_total()));
+        for (Senior* s : seniors) delete s;
+        res.add_check(big.size() == 0 && big.calculate_total() == 0, "Departament not empty after deleting its employees");
+    }
+
+    // Payroll::run recalculates every salary and resyncs the totals, with
+    // one thread or several, and runs a departament listed twice once.
+    for (unsigned threads : {1u, 4u}) {
+        Departament a, b;
+        vector<Employee*> staff;
+        for (int i = 0; i < 20000; ++i) {
+            int p = i % 6, ex = (i * 7) % 9;
+            Employee* e;
+            switch ((i * 2654435761u) % 4) {
+                case 0: e = new Intern("Run_" + to_string(i), p, ex, Role::Intern, pool[0]); break;
+                case 1: e = new Junior("Run_" + to_string(i), p, ex, Role::Junior, pool[0]); break;
+                case 2: e = new Middle("Run_" + to_string(i), p, ex, Role::Middle, pool[1]); break;
+                default: e = new Senior("Run_" + to_string(i), p, ex, Role::Senior, {pool[0]}); break;
+            }
+            staff.push_back(e);
+            (i % 3 ? a : b).add_employee(e);
+        }
+        int64_t total = Payroll::run({&a, &b, &a}, threads);
+        int64_t expected = 0;
+        bool fresh = true;
+        for (Employee* e : staff) {
+            int before = e->get_salary();
+            e->calculate_salary();
+            fresh = fresh && before == e->get_salary();
+            expected += e->get_salary();
+        }
+        res.add_check(fresh, "Payroll::run left stale salaries with " + to_string(threads) + " threads");
+        res.add_check(total == expected && a.calculate_total() + b.calculate_total() == expected,
+                      "Payroll::run total " + to_string(total) + ", expected " + to_string(expected));
+        staff[0]->set_projects(9);
+        staff[0]->calculate_salary();
+        res.add_check(a.calculate_total() + b.calculate_total() == sum_of(staff),
+                      "Departament total not incremental after Payroll::run");
+
+        // EmployeeTable rows carry the employees' fields and recompute the
+        // same salaries as the role classes.
+        EmployeeTable table;
+        for (Employee* e : staff) table.add(*e);
+        for (size_t r = 0; r < table.size(); ++r) table.salary[r] = -1;
+        res.add_check(table.calculate_salaries() == sum_of(staff) && table.total() == sum_of(staff),
+                      "EmployeeTable total " + to_string(table.total()) + ", expected " + to_string(sum_of(staff)));
+        bool same = true;
+        for (size_t r = 0; r < table.size(); ++r) {
+            Employee* e = staff[r];
+            Employee* manager = e->get_manager();
+            same = same && table.id[r] == e->get_id() && table.salary[r] == e->get_salary()
+                && table.manager_id[r] == (manager ? manager->get_id() : 0)
+                && table.reports[r] == int(e->get_reports());
+        }
+        res.add_check(same, "EmployeeTable rows differ from the employees");
+        for (Employee* e : staff) delete e;
+    }
+
+    // OrgTree subtree totals match a walk of the table after rows arrive
+    // before their managers, salary changes, re-parenting and a recompute.
+    {
+        const int n = 3000;
+        mt19937 rng(11);
+        vector<int> order(n);
+        for (int i = 0; i < n; ++i) order[i] = i;
+        shuffle(order.begin(), order.end(), rng);
+
+        EmployeeTable table;
+        table.add(1000000, Role::Senior, 2, 3, 4, 0);
+        OrgTree tree(table);
+        for (int i : order) {
+            uint64_t manager = i == 0 ? 1000000 : 1000000 + 1 + rng() % i;
+            size_t row = table.add(1000000 + 1 + i, static_cast<Role>(i % 4), i % 5, i % 7, i % 3, manager);
+            table.set_salary(row, 1000 + i);
+        }
+        auto walk_check = [&](const string& when) {
+            vector<OrgTree::Totals> expected(table.size());
+            bool ok = true;
+            for (size_t r = 0; r < table.size(); ++r) {
+                for (uint32_t a = uint32_t(r); a != OrgTree::none; a = tree.parent(a)) {
+                    expected[a].salary += table.salary[r];
+                    expected[a].headcount += 1;
+                    expected[a].roles[table.role[r]] += 1;
+                }
+                uint32_t manager = tree.row_of(table.manager_id[r]);
+                ok = ok && tree.parent(r) == manager;
+            }
+            for (size_t r = 0; r < table.size(); ++r) {
+                const OrgTree::Totals& t = tree.subtree(r);
+                ok = ok && t.salary == expected[r].salary && t.headcount == expected[r].headcount && t.roles == expected[r].roles;
+            }
+            res.add_check(ok, "OrgTree totals wrong " + when);
+        };
+        walk_check("after building");
+        res.add_check(tree.subtree(0).headcount == n + 1, "OrgTree root does not hold everyone");
+
+        for (int k = 0; k < 500; ++k) table.set_salary(rng() % table.size(), int(rng() % 100000));
+        walk_check("after salary changes");
+
+        for (int k = 0; k < 500; ++k) table.set_manager(1 + rng() % n, table.id[rng() % table.size()]);
+        bool refused = !table.set_manager(0, table.id[1 + rng() % n]) && !table.set_manager(5, table.id[5]);
+        res.add_check(refused && tree.parent(0) == OrgTree::none, "OrgTree accepted a cycle");
+        walk_check("after re-parenting");
+
+        for (size_t r = 0; r < table.size(); ++r) table.projects[r] = int(r % 9);
+        table.calculate_salaries();
+        walk_check("after calculate_salaries");
+
+        // The cached bottom-up order must follow re-parenting and new rows.
+        for (int k = 0; k < 200; ++k) table.set_manager(1 + rng() % n, table.id[rng() % table.size()]);
+        table.add(3000000, Role::Junior, 1, 1, 0, table.id[7]);
+        for (size_t r = 0; r < table.size(); ++r) table.exp[r] = int(r % 13);
+        table.calculate_salaries();
+        walk_check("after re-parenting and a recompute");
+
+        // Moves carry the rows, not the tree; the tree of the emptied table
+        // is rebuilt.
+        size_t rows = table.size();
+        int64_t before = tree.subtree(0).salary;
+        EmployeeTable moved(std::move(table));
+        res.add_check(moved.size() == rows && moved.attached() == nullptr && table.size() == 0,
+                      "EmployeeTable move did not carry the rows alone");
+        OrgTree moved_tree(moved);
+        res.add_check(moved_tree.subtree(0).salary == before && moved_tree.subtree(0).headcount == rows,
+                      "OrgTree of a moved table differs");
+        table = std::move(moved);
+        res.add_check(table.size() == rows && moved.size() == 0 && table.attached() == &tree && tree.subtree(0).salary == before,
+                      "EmployeeTable move assignment did not rebuild the attached tree");
+        walk_check("after moving the table back");
+    }
+
+    // EmployeeImport resolves references in both directions, unquotes names
+    // and skips bad rows, with one thread or several.
+    {
+        const string path = "employee_import_check.csv";
+        {
+            ofstream csv(path, ios::binary);
+            csv << "id,name,role,exp,projects,salary,mentor,team_lead,subordinates\r\n"
+                << "7,Intern_A,Intern,0,1,1,9,,\r\n"
+                << "9,\"Doe, \"\"Jay\"\"\",Senior,4,3,0,,,7 12 404\n"
+                << "12,Middle_B,Middle,2,5,0,,9,\n"
+                << "13,Junior_C,Junior,1,2,0,,77,\n"
+                << "14,Broken,Boss,1,2,0,,,\n"
+                << "15,\"Unclosed,Senior,1,2,0,,,\n"
+                << "\n"
+                << "16,Intern_D,Intern,0,0,0,,,";
+        }
+        for (unsigned threads : {1u, 3u}) {
+            EmployeeImport import;
+            string out;
+            bool loaded = false;
+            capture_print_info([&]() { loaded = import.load(path, threads); }, out);
+            string t = " with " + to_string(threads) + " threads";
+            res.add_check(loaded && import.size() == 5 && import.skipped() == 2 && import.unresolved() == 2,
+                          "EmployeeImport counts wrong" + t + ": " + out);
+            if (!loaded || import.size() != 5) continue;
+
+            const vector<Employee*>& e = import.employees();
+            res.add_check(import.source_id(1) == 9 && e[1]->get_name() == "Doe, \"Jay\"" && e[1]->get_role() == Role::Senior,
+                          "EmployeeImport misread a quoted row" + t);
+            res.add_check(e[0]->get_manager() == e[1] && e[2]->get_manager() == e[1] && e[3]->get_manager() == nullptr
+                          && e[4]->get_manager() == nullptr, "EmployeeImport resolved managers wrong" + t);
+            res.add_check(e[1]->get_reports() == 2, "EmployeeImport resolved subordinates wrong" + t);
+            bool salaries = true;
+            for (Employee* x : e)
+                salaries = salaries && x->get_salary() == expected_salary_for(x->get_role(), x->get_projects(), x->get_exp(), x->get_reports());
+            res.add_check(salaries, "EmployeeImport salaries not recalculated" + t);
+        }
+        remove(path.c_str());
+    }
+
+    // ReportWriter: CSV quotes fields with commas, quotes or newlines and
+    // doubles quotes, none() keeps the columns aligned, JSON escapes control
+    // characters and writes non-finite numbers as null.
+    {
+        Intern quoted("Quote\"d\tTab", 1, 0, Role::Intern, nullptr);
+        Senior lead("Lead, Big", 2, 3, Role::Senior, {&quoted});
+        Junior broken("Line\nBreak", 1, 1, Role::Junior, &lead);
+        Middle plain("Back\\slash", 2, 2, Role::Middle, nullptr);
+        vector<Employee*> staff = {&quoted, &lead, &broken, &plain};
+        for (Employee* e : staff) e->calculate_salary();
+        auto id = [](const Employee& e) { return to_string(e.get_id()); };
+
+        ostringstream csv;
+        {
+            ReportWriter writer(csv, ReportFormat::Csv);
+            report_employees(writer, staff);
+        }
+        string expected_csv = "id,name,role,exp,projects,salary,mentor,team_lead,subordinates\n"
+            + id(quoted) + ",\"Quote\"\"d\tTab\",Intern,0,1,250000,,,\n"
+            + id(lead) + ",\"Lead, Big\",Senior,3,2,1550000,,,\"Quote\"\"d\tTab\"\n"
+            + id(broken) + ",\"Line\nBreak\",Junior,1,1,100000,,\"Lead, Big\",\n"
+            + id(plain) + ",Back\\slash,Middle,2,2,400000,,,\n";
+        res.add_check(csv.str() == expected_csv, "CSV report wrong:\n" + csv.str() + "expected:\n" + expected_csv);
+
+        ostringstream json;
+        {
+            ReportWriter writer(json, ReportFormat::JsonLines);
+            report_employees(writer, staff);
+        }
+        string expected_json =
+            "{\"id\":" + id(quoted) + ",\"name\":\"Quote\\\"d\\u0009Tab\",\"role\":\"Intern\",\"exp\":0,\"projects\":1,\"salary\":250000}\n"
+            "{\"id\":" + id(lead) + ",\"name\":\"Lead, Big\",\"role\":\"Senior\",\"exp\":3,\"projects\":2,\"salary\":1550000,\"subordinates\":\"Quote\\\"d\\u0009Tab\"}\n"
+            "{\"id\":" + id(broken) + ",\"name\":\"Line\\u000aBreak\",\"role\":\"Junior\",\"exp\":1,\"projects\":1,\"salary\":100000,\"team_lead\":\"Lead, Big\"}\n"
+            "{\"id\":" + id(plain) + ",\"name\":\"Back\\\\slash\",\"role\":\"Middle\",\"exp\":2,\"projects\":2,\"salary\":400000}\n";
+        res.add_check(json.str() == expected_json, "JSON report wrong:\n" + json.str() + "expected:\n" + expected_json);
+
+        ostringstream numbers;
+        {
+            ReportWriter writer(numbers, ReportFormat::JsonLines);
+            writer.beginRecord();
+            writer.field("nan", numeric_limits<double>::quiet_NaN());
+            writer.field("inf", numeric_limits<double>::infinity());
+            writer.field("neg", -numeric_limits<double>::infinity());
+            writer.field("half", 0.5);
+            writer.none("skipped");
+            writer.field("ok", true);
+            writer.endRecord();
+        }
+        res.add_check(numbers.str() == "{\"nan\":null,\"inf\":null,\"neg\":null,\"half\":0.5,\"ok\":true}\n",
+                      "JSON non-finite numbers not null: " + numbers.str());
+    }
+
     // Cleanup created employees and pool
     for (Employee* e : created) delete e;
     for (Employee* e : pool) delete e;
 
+    // Stress: ids stay unique when employees are created from many threads.
+    {
+        const int threads = 16, per_thread = 20000;
+        vector<vector<uint64_t>> ids(threads);
+        vector<thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&ids, t]() {
+                ids[t].reserve(per_thread);
+                for (int i = 0; i < per_thread; ++i) {
+                    Junior j("Stress_" + to_string(t), 1, 1, Role::Junior, nullptr);
+                    ids[t].push_back(j.get_id());
+                }
+            });
+        }
+        for (thread& w : workers) w.join();
+
+        vector<uint64_t> all;
+        for (int t = 0; t < threads; ++t) {
+            res.add_check(is_sorted(ids[t].begin(), ids[t].end()), "ids not increasing within thread " + to_string(t));
+            all.insert(all.end(), ids[t].begin(), ids[t].end());
+        }
+        sort(all.begin(), all.end());
+        res.add_check(all.front() > 0, "id 0 handed out");
+        res.add_check(adjacent_find(all.begin(), all.end()) == all.end(),
+                      "duplicate ids across " + to_string(threads) + " threads");
+    }
+
     // Summary
     cout << "Total checks performed: " << res.total_checks << endl;
     if (res.failed == 0) {
@@ -0,0 +1,43 @@
+#ifndef IDALLOCATOR_HPP
+#define IDALLOCATOR_HPP
+
+#include <atomic>
+#include <cstdint>
+
+// Unique 64-bit ids, starting at 1, safe to take from any thread. Shared by
+// the Zoo and the Payroll system.
+// A thread reserves blockSize ids with one fetch_add on the shared counter
+// and numbers from that block locally, so the counter's cache line moves
+// between cores once per block instead of once per id. Ids from one thread
+// increase; ids across threads interleave by block.
+class IdAllocator {
+public:
+    static constexpr std::uint64_t blockSize = 1024;
+
+    static std::uint64_t next() {
+        Block& block = local();
+        if (block.next == block.end) {
+            block.next = counter.fetch_add(blockSize, std::memory_order_relaxed) + 1;
+            block.end = block.next + blockSize;
+        }
+        return block.next++;
+    }
+
+    // Ids below this have been reserved by some thread, not necessarily used.
+    static std::uint64_t reserved() { return counter.load(std::memory_order_relaxed) + 1; }
+
+private:
+    struct Block {
+        std::uint64_t next = 0;
+        std::uint64_t end = 0;
+    };
+
+    static Block& local() {
+        thread_local Block block;
+        return block;
+    }
+
+    alignas(64) inline static std::atomic<std::uint64_t> counter{0};
+};
+
+#endif
@@ -0,0 +1,91 @@
+// bench.cpp
+// Benchmarks for IdAllocator (C++17)
+// - Raw ids from 16 threads: the old unsynchronized ++id (as a relaxed
+//   load and store, counting the duplicates it hands out), one shared
+//   atomic fetch_add per id, and IdAllocator's per-thread blocks.
+// - Objects from 16 threads: Payroll Juniors, and Zoo animals added to one
+//   ZooWorld per thread.
+// Build:
+//   g++ -std=c++17 -O2 -pthread bench.cpp ../EmployeePayrollSustem/EmoloyeePayrollSystem.cpp ../Zoo/ZooWorld.cpp ../Zoo/ZooIndex.cpp ../Zoo/Symbols.cpp ../WorkStealingPool/WorkStealingPool.cpp ../Report/ReportWriter.cpp -o bench
+// Run:
+//   ./bench [ids per thread]
+
+#include "IdAllocator.hpp"
+#include "../EmployeePayrollSustem/EmployeePayrollSystem.hpp"
+#include "../Zoo/ZooWorld.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsed_ms(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+const int threads = 16;
+
+alignas(64) static std::atomic<std::uint64_t> shared{0};
+
+// Runs take(t, i) per thread and id, collects the ids, and reports
+// throughput and duplicates.
+template <typename Take>
+static void run(const char* name, std::size_t per_thread, Take take) {
+    std::vector<std::vector<std::uint64_t>> ids(threads, std::vector<std::uint64_t>(per_thread));
+    std::vector<std::thread> workers;
+    auto start = Clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            std::uint64_t* out = ids[t].data();
+            for (std::size_t i = 0; i < per_thread; ++i) out[i] = take();
+        });
+    }
+    for (std::thread& w : workers) w.join();
+    double ms = elapsed_ms(start);
+
+    std::vector<std::uint64_t> all;
+    all.reserve(threads * per_thread);
+    for (const auto& v : ids) all.insert(all.end(), v.begin(), v.end());
+    std::sort(all.begin(), all.end());
+    std::size_t duplicates = all.size() - (std::unique(all.begin(), all.end()) - all.begin());
+
+    std::cout << std::left << std::setw(26) << name
+              << " Mids/s=" << std::setw(10) << threads * per_thread / (ms * 1000.0)
+              << " duplicates=" << duplicates << std::endl;
+}
+
+int main(int argc, char** argv) {
+    std::size_t per_thread = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    std::cout << "threads=" << threads << " hardware=" << std::thread::hardware_concurrency()
+              << " ids/thread=" << per_thread << std::endl;
+
+    run("unsynchronized ++id", per_thread, [] {
+        std::uint64_t id = shared.load(std::memory_order_relaxed) + 1;
+        shared.store(id, std::memory_order_relaxed);
+        return id;
+    });
+    shared = 0;
+    run("atomic fetch_add per id", per_thread, [] {
+        return shared.fetch_add(1, std::memory_order_relaxed) + 1;
+    });
+    run("IdAllocator", per_thread, [] { return IdAllocator::next(); });
+
+    std::size_t objects = per_thread / 10;
+    run("new Junior", objects, [] {
+        Junior j("Junior", 1, 1, Role::Junior, nullptr);
+        return j.get_id();
+    });
+    run("ZooWorld::add", objects, [] {
+        thread_local ZooWorld world;
+        AnimalHandle h = world.add(Kind::Lion, "Lion");
+        return world.pool(h.kind).id[world.row(h)];
+    });
+    return 0;
+}
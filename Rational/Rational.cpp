@@ -1,4 +1,6 @@
 #include "Rational.hpp"
+#include <cmath>
+#include <limits>
 
 
 void Rational::reduce_helper() {
@@ -263,3 +265,114 @@ Rational::operator double() const {
     return (double)this->num / (double)this->denum;
 
 }
+
+
+//Conversions from double
+// Continued fraction expansion of x: convergents p/q are built until the next
+// denominator would exceed max_denominator, then the best semiconvergent is
+// compared with the last convergent.
+Rational Rational::from_double(double x, int max_denominator) {
+    if (!std::isfinite(x) || std::fabs(x) > std::numeric_limits<int>::max()) {
+        std::cout << "Double cant be represented as Rational" << std::endl;
+        return Rational();
+    }
+    if (max_denominator < 1) max_denominator = 1;
+
+    bool negative = x < 0;
+    double target = std::fabs(x);
+    double y = target;
+
+    long long p0 = 0, q0 = 1;
+    long long p1 = 1, q1 = 0;
+
+    for (int i = 0; i < 64; ++i) {
+        double a_part = std::floor(y);
+        long long a = (long long)a_part;
+        if (q1 != 0 && a > (max_denominator - q0) / q1) break;
+
+        long long q2 = q0 + a * q1;
+        long long p2 = p0 + a * p1;
+        if (q2 > max_denominator || p2 > std::numeric_limits<int>::max()) break;
+
+        p0 = p1; q0 = q1;
+        p1 = p2; q1 = q2;
+
+        double frac = y - a_part;
+        if (frac == 0 || (double)p1 / (double)q1 == target) {
+            return Rational(negative ? -(int)p1 : (int)p1, (int)q1);
+        }
+        y = 1.0 / frac;
+        if (y > (double)std::numeric_limits<long long>::max() / 2) break;
+    }
+
+    // Largest semiconvergent that still fits under max_denominator.
+    long long k = (max_denominator - q0) / q1;
+    long long sp = p0 + k * p1;
+    long long sq = q0 + k * q1;
+    if (sp > std::numeric_limits<int>::max()) {
+        sp = p1;
+        sq = q1;
+    }
+
+    double err_conv = std::fabs((double)p1 / (double)q1 - target);
+    double err_semi = std::fabs((double)sp / (double)sq - target);
+    long long n = p1, d = q1;
+    if (err_semi < err_conv) {
+        n = sp;
+        d = sq;
+    }
+
+    return Rational(negative ? -(int)n : (int)n, (int)d);
+}
+
+void Rational::from_double(const double* xs, std::size_t n, Rational* out, int max_denominator) {
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = from_double(xs[i], max_denominator);
+    }
+}
+
+// Walks the Stern-Brocot tree towards num/denum one continued fraction term at
+// a time, so it only takes O(log denum) steps. Arithmetic is exact.
+Rational Rational::limit_denominator(int max_denominator) const {
+    if (max_denominator < 1) max_denominator = 1;
+    if (denum <= max_denominator) return *this;
+
+    bool negative = num < 0;
+    long long n = negative ? -(long long)num : num;
+    long long d = denum;
+
+    long long p0 = 0, q0 = 1;
+    long long p1 = 1, q1 = 0;
+
+    while (d != 0) {
+        long long a = n / d;
+        long long q2 = q0 + a * q1;
+        if (q2 > max_denominator) break;
+
+        long long p2 = p0 + a * p1;
+        p0 = p1; q0 = q1;
+        p1 = p2; q1 = q2;
+
+        long long r = n - a * d;
+        n = d;
+        d = r;
+    }
+
+    long long k = (max_denominator - q0) / q1;
+    long long sp = p0 + k * p1;
+    long long sq = q0 + k * q1;
+
+    // Compare |p1/q1 - x| and |sp/sq - x| by cross multiplication instead of
+    // dividing, so close candidates are not decided by double rounding.
+    long long an = negative ? -(long long)num : num;
+    long double err_conv = std::fabs((long double)(p1 * denum - an * q1)) * sq;
+    long double err_semi = std::fabs((long double)(sp * denum - an * sq)) * q1;
+
+    long long rn = p1, rd = q1;
+    if (err_semi < err_conv) {
+        rn = sp;
+        rd = sq;
+    }
+
+    return Rational(negative ? -(int)rn : (int)rn, (int)rd);
+}
@@ -1,3 +1,7 @@
+#ifndef RATIONAL_HPP
+#define RATIONAL_HPP
+
+#include <cstddef>
 #include <iostream>
 #include <numeric>
 
@@ -61,4 +65,11 @@ class Rational {
 
         explicit operator double() const;
 
-};
\ No newline at end of file
+        //Conversions from double
+        static Rational from_double(double x, int max_denominator = 1000000);
+        static void from_double(const double* xs, std::size_t n, Rational* out, int max_denominator = 1000000);
+        Rational limit_denominator(int max_denominator = 1000000) const;
+
+};
+
+#endif
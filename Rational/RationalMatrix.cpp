@@ -0,0 +1,275 @@
+#include "RationalMatrix.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <thread>
+#include "../WorkStealingPool/WorkStealingPool.hpp"
+
+namespace {
+
+// Integer copy of [A | B] with every row multiplied by the lcm of its
+// denominators. Scaling a row of the augmented system does not change its
+// solution; determinant() divides the scales back out.
+struct IntSystem {
+    std::size_t n = 0;
+    std::size_t width = 0;
+    std::vector<long long> m;
+    std::vector<long long> scale;
+    int sign = 1;
+    long long pivot = 1;
+    bool singular = false;
+    std::atomic<bool> overflow{false};
+
+    long long& at(std::size_t r, std::size_t c) { return m[r * width + c]; }
+};
+
+bool checked_mul(long long a, long long b, long long& out) {
+    return !__builtin_mul_overflow(a, b, &out);
+}
+
+void fold_scale(IntSystem& s, std::size_t r, const Rational* row, std::size_t count) {
+    for (std::size_t c = 0; c < count; ++c) {
+        long long d = row[c].denominator();
+        long long l = s.scale[r] / std::gcd(s.scale[r], d);
+        if (!checked_mul(l, d, s.scale[r])) s.overflow = true;
+    }
+}
+
+void write_row(IntSystem& s, std::size_t r, const Rational* row, std::size_t count, std::size_t offset) {
+    for (std::size_t c = 0; c < count; ++c) {
+        long long factor = s.scale[r] / row[c].denominator();
+        if (!checked_mul(row[c].numerator(), factor, s.at(r, offset + c))) s.overflow = true;
+    }
+}
+
+void load(IntSystem& s, const RationalMatrix& a, const RationalMatrix* b) {
+    std::size_t extra = b ? b->cols() : 0;
+    s.n = a.rows();
+    s.width = a.cols() + extra;
+    s.m.assign(s.n * s.width, 0);
+    s.scale.assign(s.n, 1);
+    for (std::size_t r = 0; r < s.n; ++r) {
+        fold_scale(s, r, &a(r, 0), a.cols());
+        if (extra) fold_scale(s, r, &(*b)(r, 0), extra);
+        if (s.overflow) return;
+
+        write_row(s, r, &a(r, 0), a.cols(), 0);
+        if (extra) write_row(s, r, &(*b)(r, 0), extra, a.cols());
+    }
+}
+
+// (m[i][j] * pivot - m[i][k] * m[k][j]) / prev for rows [begin, end).
+// In Gauss-Jordan mode rows above k are reduced as well and their diagonal
+// becomes the new pivot, so the left block ends up as pivot * I.
+void update_rows(IntSystem& s, std::size_t k, long long prev, bool jordan, std::size_t begin, std::size_t end) {
+    long long piv = s.at(k, k);
+    const long long* pivot_row = &s.m[k * s.width];
+    for (std::size_t i = begin; i < end; ++i) {
+        if (i == k || (!jordan && i < k)) continue;
+        long long* row = &s.m[i * s.width];
+        long long f = row[k];
+        for (std::size_t j = k + 1; j < s.width; ++j) {
+            long long lhs, rhs;
+            if (checked_mul(row[j], piv, lhs) && checked_mul(f, pivot_row[j], rhs)
+                && !__builtin_sub_overflow(lhs, rhs, &lhs)) {
+                row[j] = lhs / prev;
+                continue;
+            }
+            __int128 wide = (__int128)row[j] * piv - (__int128)f * pivot_row[j];
+            wide /= prev;
+            if (wide > std::numeric_limits<long long>::max() || wide < std::numeric_limits<long long>::min()) {
+                s.overflow = true;
+                return;
+            }
+            row[j] = (long long)wide;
+        }
+        row[k] = 0;
+        if (i < k) row[i] = piv;
+    }
+}
+
+void eliminate(IntSystem& s, bool jordan, const Elimination& how) {
+    std::size_t n = s.n;
+    unsigned workers = how.threads ? how.threads : std::thread::hardware_concurrency();
+    if (workers == 0) workers = 1;
+    bool parallel = n >= how.parallel_rows && workers > 1;
+
+    // One set of threads for the whole elimination; each pivot hands them
+    // its rows in a few chunks per thread.
+    std::unique_ptr<WorkStealingPool> pool;
+    if (parallel) pool = std::make_unique<WorkStealingPool>(workers);
+
+    long long prev = 1;
+    for (std::size_t k = 0; k < n && !s.overflow; ++k) {
+        std::size_t p = k;
+        while (p < n && s.at(p, k) == 0) ++p;
+        if (p == n) {
+            s.singular = true;
+            return;
+        }
+        if (p != k) {
+            std::swap_ranges(&s.m[k * s.width], &s.m[k * s.width] + s.width, &s.m[p * s.width]);
+            std::swap(s.scale[k], s.scale[p]);
+            s.sign = -s.sign;
+        }
+
+        std::size_t first = jordan ? 0 : k + 1;
+        std::size_t count = n - first;
+        if (!parallel || count < 2 * workers) {
+            update_rows(s, k, prev, jordan, first, n);
+        } else {
+            std::size_t chunks = std::min<std::size_t>(count, std::size_t(workers) * 4);
+            std::size_t chunk = (count + chunks - 1) / chunks;
+            pool->run((count + chunk - 1) / chunk, [&](std::size_t i) {
+                std::size_t begin = first + i * chunk;
+                update_rows(s, k, prev, jordan, begin, std::min(n, begin + chunk));
+            });
+        }
+        prev = s.at(k, k);
+    }
+    s.pivot = prev;
+}
+
+bool make_rational(long long num, long long den, Rational& out) {
+    if (den < 0) {
+        num = -num;
+        den = -den;
+    }
+    long long g = std::gcd(num, den);
+    if (g != 0) {
+        num /= g;
+        den /= g;
+    }
+    if (num > std::numeric_limits<int>::max() || num < std::numeric_limits<int>::min()
+        || den > std::numeric_limits<int>::max()) {
+        return false;
+    }
+    out = Rational((int)num, (int)den);
+    return true;
+}
+
+}
+
+//Constructors
+RationalMatrix::RationalMatrix(std::size_t rows, std::size_t cols)
+    : rows_(rows), cols_(cols), data(rows * cols) {}
+
+RationalMatrix RationalMatrix::identity(std::size_t n) {
+    RationalMatrix m(n, n);
+    for (std::size_t i = 0; i < n; ++i) m(i, i) = Rational(1);
+    return m;
+}
+
+// Exact linear algebra
+Rational RationalMatrix::determinant(Elimination how) const {
+    if (rows_ != cols_) {
+        std::cout << "Determinant needs a square matrix" << std::endl;
+        return Rational();
+    }
+    if (rows_ == 0) return Rational(1);
+
+    IntSystem s;
+    load(s, *this, nullptr);
+    if (!s.overflow) eliminate(s, false, how);
+    if (s.singular) return Rational();
+
+    // det(A) = sign * pivot / prod(scale); divide out one scale at a time.
+    long long num = s.sign * s.pivot;
+    long long den = 1;
+    for (long long sc : s.scale) {
+        long long g = std::gcd(num, sc);
+        num /= g;
+        if (!checked_mul(den, sc / g, den)) s.overflow = true;
+    }
+
+    Rational result;
+    if (s.overflow || !make_rational(num, den, result)) {
+        std::cout << "Determinant overflows 64-bit elimination" << std::endl;
+        return Rational();
+    }
+    return result;
+}
+
+RationalMatrix RationalMatrix::inverse(Elimination how) const {
+    if (rows_ != cols_) {
+        std::cout << "Inverse needs a square matrix" << std::endl;
+        return RationalMatrix();
+    }
+    RationalMatrix id = identity(rows_);
+    IntSystem s;
+    load(s, *this, &id);
+    if (!s.overflow) eliminate(s, true, how);
+    if (s.singular) {
+        std::cout << "Matrix is singular" << std::endl;
+        return RationalMatrix(rows_, cols_);
+    }
+
+    RationalMatrix result(rows_, cols_);
+    for (std::size_t r = 0; r < rows_ && !s.overflow; ++r) {
+        for (std::size_t c = 0; c < cols_; ++c) {
+            if (!make_rational(s.at(r, cols_ + c), s.pivot, result(r, c))) {
+                s.overflow = true;
+                break;
+            }
+        }
+    }
+    if (s.overflow) {
+        std::cout << "Inverse overflows 64-bit elimination" << std::endl;
+        return RationalMatrix(rows_, cols_);
+    }
+    return result;
+}
+
+std::vector<Rational> RationalMatrix::solve(const std::vector<Rational>& b, Elimination how) const {
+    if (rows_ != cols_ || b.size() != rows_) {
+        std::cout << "Solve needs a square matrix and a matching right-hand side" << std::endl;
+        return std::vector<Rational>(b.size());
+    }
+    RationalMatrix rhs(rows_, 1);
+    for (std::size_t r = 0; r < rows_; ++r) rhs(r, 0) = b[r];
+
+    IntSystem s;
+    load(s, *this, &rhs);
+    if (!s.overflow) eliminate(s, true, how);
+    if (s.singular) {
+        std::cout << "Matrix is singular" << std::endl;
+        return std::vector<Rational>(rows_);
+    }
+
+    std::vector<Rational> x(rows_);
+    for (std::size_t r = 0; r < rows_ && !s.overflow; ++r) {
+        if (!make_rational(s.at(r, cols_), s.pivot, x[r])) s.overflow = true;
+    }
+    if (s.overflow) {
+        std::cout << "Solve overflows 64-bit elimination" << std::endl;
+        return std::vector<Rational>(rows_);
+    }
+    return x;
+}
+
+RationalMatrix operator*(const RationalMatrix& lhs, const RationalMatrix& rhs) {
+    RationalMatrix result(lhs.rows_, rhs.cols_);
+    for (std::size_t i = 0; i < lhs.rows_; ++i) {
+        for (std::size_t k = 0; k < lhs.cols_; ++k) {
+            const Rational& a = lhs(i, k);
+            if (!a) continue;
+            for (std::size_t j = 0; j < rhs.cols_; ++j) {
+                result(i, j) += a * rhs(k, j);
+            }
+        }
+    }
+    return result;
+}
+
+std::ostream& operator<<(std::ostream& os, const RationalMatrix& m) {
+    for (std::size_t r = 0; r < m.rows_; ++r) {
+        for (std::size_t c = 0; c < m.cols_; ++c) {
+            os << m(r, c).numerator() << "/" << m(r, c).denominator();
+            if (c + 1 < m.cols_) os << " ";
+        }
+        os << std::endl;
+    }
+    return os;
+}
@@ -0,0 +1,55 @@
+#ifndef RATIONAL_MATRIX_HPP
+#define RATIONAL_MATRIX_HPP
+
+#include "Rational.hpp"
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+// Dense matrix of Rationals stored row-major in one contiguous vector.
+// determinant/inverse/solve clear the denominators row by row and run
+// fraction-free (Bareiss) elimination on 64-bit integers, so every step is
+// exact. If an intermediate minor does not fit in 64 bits, or a result does
+// not fit in Rational's int, an error is printed and a zero result returned.
+//
+// That bounds the size in practice: the minors of a matrix of random small
+// entries outgrow 64 bits past about 9x9, and scaling a row by the lcm of
+// its denominators multiplies them again. Hundreds of unknowns solve only
+// when the minors stay small, as in banded systems or the dense
+// unimodular ones of bench.cpp, and determinant() also needs the product of
+// the row denominators to fit.
+// How determinant/inverse/solve spread their work: systems with at least
+// parallel_rows rows split each pivot's row updates over threads.
+// threads == 0 means hardware_concurrency.
+struct Elimination {
+    unsigned threads = 0;
+    std::size_t parallel_rows = 128;
+};
+
+class RationalMatrix {
+    std::size_t rows_;
+    std::size_t cols_;
+    std::vector<Rational> data;
+
+    public:
+        //Constructors
+        RationalMatrix() : rows_(0), cols_(0) {}
+        RationalMatrix(std::size_t rows, std::size_t cols);
+        static RationalMatrix identity(std::size_t n);
+
+        // Accessors
+        std::size_t rows() const { return rows_; }
+        std::size_t cols() const { return cols_; }
+        Rational& operator()(std::size_t r, std::size_t c) { return data[r * cols_ + c]; }
+        const Rational& operator()(std::size_t r, std::size_t c) const { return data[r * cols_ + c]; }
+
+        // Exact linear algebra
+        Rational determinant(Elimination how = Elimination()) const;
+        RationalMatrix inverse(Elimination how = Elimination()) const;
+        std::vector<Rational> solve(const std::vector<Rational>& b, Elimination how = Elimination()) const;
+
+        friend RationalMatrix operator*(const RationalMatrix& lhs, const RationalMatrix& rhs);
+        friend std::ostream& operator<<(std::ostream& os, const RationalMatrix& m);
+};
+
+#endif
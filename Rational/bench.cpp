@@ -0,0 +1,187 @@
+// bench.cpp
+// Benchmarks for Rational (C++17)
+// - from_double: accuracy against cost on random doubles for several
+//   max_denominator values, compared with naive scale-and-reduce.
+// - RationalMatrix: determinant/solve/inverse time from 10x10 to 500x500,
+//   with the largest denominator of the inverse as a growth measure.
+//   Random dense matrices stop at 9x9, where their minors outgrow 64 bits;
+//   the dense 100x100 to 400x400 case is a row-permuted min(i, j) matrix,
+//   whose minors stay small, solved with 1 and N threads and checked
+//   against the known solution.
+// Build:
+//   g++ -std=c++17 -O2 -pthread bench.cpp Rational.cpp RationalMatrix.cpp ../WorkStealingPool/WorkStealingPool.cpp -o bench
+// Run:
+//   ./bench [count]
+
+#include "Rational.hpp"
+#include "RationalMatrix.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsed_ms(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static void report(const char* name, int max_den, double ms, std::size_t n,
+                   const std::vector<double>& xs, const std::vector<Rational>& out) {
+    double sum_err = 0, max_err = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        double err = std::fabs((double)out[i] - xs[i]);
+        sum_err += err;
+        if (err > max_err) max_err = err;
+    }
+    std::cout << std::left << std::setw(16) << name
+              << " max_den=" << std::setw(8) << max_den
+              << " ns/value=" << std::setw(10) << ms * 1e6 / n
+              << " mean_err=" << std::setw(12) << sum_err / n
+              << " max_err=" << max_err << std::endl;
+}
+
+static void bench_matrix(const char* name, const RationalMatrix& a) {
+    std::size_t n = a.rows();
+    std::vector<Rational> b(n);
+    for (std::size_t i = 0; i < n; ++i) b[i] = Rational((int)(i % 7) - 3);
+
+    auto start = Clock::now();
+    Rational det = a.determinant();
+    double det_ms = elapsed_ms(start);
+
+    start = Clock::now();
+    std::vector<Rational> x = a.solve(b);
+    double solve_ms = elapsed_ms(start);
+
+    start = Clock::now();
+    RationalMatrix inv = a.inverse();
+    double inv_ms = elapsed_ms(start);
+
+    int max_den = 1;
+    for (std::size_t r = 0; r < n; ++r) {
+        for (std::size_t c = 0; c < n; ++c) {
+            if (inv(r, c).denominator() > max_den) max_den = inv(r, c).denominator();
+        }
+    }
+
+    std::cout << std::left << std::setw(12) << name
+              << " n=" << std::setw(5) << n
+              << " det_ms=" << std::setw(10) << det_ms
+              << " solve_ms=" << std::setw(10) << solve_ms
+              << " inverse_ms=" << std::setw(10) << inv_ms
+              << " det=" << det.numerator() << "/" << det.denominator()
+              << " max_inv_den=" << max_den << std::endl;
+}
+
+// Rationals are kept reduced with a positive denominator, so equal values
+// have equal parts. Rational's operator== compares truncated quotients.
+static bool same(const Rational& a, const Rational& b) {
+    return a.numerator() == b.numerator() && a.denominator() == b.denominator();
+}
+
+// A dense n x n system with a few hundred unknowns that 64-bit Bareiss can
+// solve: rows of the min(i, j) matrix in random order (det +-1, tridiagonal
+// inverse) and an integer right-hand side built from a known solution.
+static void bench_dense_solve(std::size_t n, std::mt19937& rng) {
+    std::vector<std::size_t> perm(n);
+    for (std::size_t i = 0; i < n; ++i) perm[i] = i;
+    std::shuffle(perm.begin(), perm.end(), rng);
+    RationalMatrix a(n, n);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) a(i, j) = Rational((int)std::min(perm[i], j) + 1);
+    }
+    RationalMatrix x0(n, 1);
+    for (std::size_t i = 0; i < n; ++i) x0(i, 0) = Rational((int)(rng() % 7) - 3);
+    RationalMatrix ax = a * x0;
+    std::vector<Rational> b(n);
+    for (std::size_t i = 0; i < n; ++i) b[i] = ax(i, 0);
+
+    unsigned hw = std::max(4u, std::thread::hardware_concurrency());
+    for (unsigned threads : {1u, hw}) {
+        Elimination how;
+        how.threads = threads;
+        auto start = Clock::now();
+        std::vector<Rational> x = a.solve(b, how);
+        double ms = elapsed_ms(start);
+        bool ok = true;
+        for (std::size_t i = 0; i < n; ++i) ok = ok && same(x[i], x0(i, 0));
+        std::cout << std::left << std::setw(12) << "dense-solve"
+                  << " n=" << std::setw(5) << n
+                  << " threads=" << std::setw(3) << threads
+                  << " solve_ms=" << std::setw(10) << ms
+                  << (ok ? " solution ok" : " SOLUTION WRONG") << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+
+    std::mt19937_64 rng(12345);
+    std::uniform_real_distribution<double> dist(-1000.0, 1000.0);
+    std::vector<double> xs(n);
+    for (double& x : xs) x = dist(rng);
+
+    std::vector<Rational> out(n);
+
+    for (int max_den : {10, 1000, 1000000}) {
+        auto start = Clock::now();
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = Rational((int)std::llround(xs[i] * max_den), max_den);
+        }
+        report("scale+reduce", max_den, elapsed_ms(start), n, xs, out);
+
+        start = Clock::now();
+        Rational::from_double(xs.data(), n, out.data(), max_den);
+        report("from_double", max_den, elapsed_ms(start), n, xs, out);
+
+        start = Clock::now();
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = out[i].limit_denominator(max_den / 10 > 0 ? max_den / 10 : 1);
+        }
+        report("limit_denom/10", max_den / 10 > 0 ? max_den / 10 : 1, elapsed_ms(start), n, xs, out);
+    }
+
+    std::mt19937 mrng(777);
+    std::uniform_int_distribution<int> entry(-3, 3), den(1, 3);
+    for (std::size_t n : {10, 20, 50, 100, 200, 500}) {
+        RationalMatrix tri(n, n);
+        for (std::size_t i = 0; i < n; ++i) {
+            tri(i, i) = Rational(2);
+            if (i + 1 < n) {
+                tri(i, i + 1) = Rational(-1);
+                tri(i + 1, i) = Rational(-1);
+            }
+        }
+        bench_matrix("tridiagonal", tri);
+    }
+    for (std::size_t n : {4, 8, 10, 12}) {
+        RationalMatrix tri(n, n);
+        for (std::size_t i = 0; i < n; ++i) {
+            tri(i, i) = Rational(2);
+            if (i + 1 < n) {
+                tri(i, i + 1) = Rational(-1, 2);
+                tri(i + 1, i) = Rational(-1, 3);
+            }
+        }
+        bench_matrix("tri-frac", tri);
+    }
+    for (std::size_t n : {3, 5, 7, 9}) {
+        RationalMatrix dense(n, n);
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t j = 0; j < n; ++j) dense(i, j) = Rational(entry(mrng), den(mrng));
+            dense(i, i) += Rational(10);
+        }
+        bench_matrix("dense", dense);
+    }
+    for (std::size_t n : {100, 200, 300, 400}) {
+        bench_dense_solve(n, mrng);
+    }
+
+    return 0;
+}
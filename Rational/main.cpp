@@ -3,14 +3,17 @@
 // - Runs 200 deterministic randomized iterations ("levels")
 // - Exercises constructors, copy/move, arithmetic, compound assignments,
 //   increments/decrements, comparisons, streaming, and double conversion.
+// - Checks from_double/limit_denominator and RationalMatrix determinant,
+//   inverse and solve on fixed cases, including their error paths.
 // - Uses SFINAE to detect presence of common operators/methods so this
 //   file compiles even if some operators are not implemented.
 // Build:
-//   g++ -std=c++17 main.cpp Rational.cpp -o test
+//   g++ -std=c++17 -pthread main.cpp Rational.cpp RationalMatrix.cpp ../WorkStealingPool/WorkStealingPool.cpp -o test
 // Run:
 //   ./test
 
 #include "Rational.hpp"
+#include "RationalMatrix.hpp"
 #include <algorithm>
 #include <cassert>
 #include <cctype>
@@ -510,6 +513,212 @@ void check_unary_inc_dec(T a0, Counters &c, int level) {
     }
 }
 
+// ----------------------------- Double conversions --------------------------
+static void check_value(const Rational &r, i64 num, i64 den, Counters &c, const std::string &what) {
+    ++c.total;
+    if (r.numerator() != num || r.denominator() != den) {
+        ++c.failed;
+        std::cerr << "FAIL " << what << ": expected " << num << "/" << den
+                  << " got " << r.numerator() << "/" << r.denominator() << "\n";
+    }
+}
+
+// Runs f with std::cout redirected and returns what it printed.
+static std::string captured_cout(const std::function<void()> &f) {
+    std::ostringstream out;
+    std::streambuf *old = std::cout.rdbuf(out.rdbuf());
+    f();
+    std::cout.rdbuf(old);
+    return out.str();
+}
+
+static void check_double_conversions(Counters &c) {
+    const double pi = 3.14159265358979323846;
+
+    check_value(Rational::from_double(0.5), 1, 2, c, "from_double(0.5)");
+    check_value(Rational::from_double(-0.75), -3, 4, c, "from_double(-0.75)");
+    check_value(Rational::from_double(0.1), 1, 10, c, "from_double(0.1)");
+    check_value(Rational::from_double(3.0), 3, 1, c, "from_double(3.0)");
+    check_value(Rational::from_double(0.0), 0, 1, c, "from_double(0.0)");
+    check_value(Rational::from_double(-0.0), 0, 1, c, "from_double(-0.0)");
+    check_value(Rational::from_double(pi, 7), 22, 7, c, "from_double(pi, 7)");
+    check_value(Rational::from_double(pi, 113), 355, 113, c, "from_double(pi, 113)");
+    check_value(Rational::from_double(-pi, 113), -355, 113, c, "from_double(-pi, 113)");
+    check_value(Rational::from_double(0.3, 0), 0, 1, c, "from_double(0.3, 0)");
+
+    const double xs[] = {0.5, -0.75, pi, 0.0};
+    Rational out[4];
+    Rational::from_double(xs, 4, out, 113);
+    check_value(out[0], 1, 2, c, "batch from_double[0]");
+    check_value(out[1], -3, 4, c, "batch from_double[1]");
+    check_value(out[2], 355, 113, c, "batch from_double[2]");
+    check_value(out[3], 0, 1, c, "batch from_double[3]");
+
+    // Values outside int and non-finite values print an error and give 0.
+    const double bad[] = {std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::infinity(),
+                          -std::numeric_limits<double>::infinity(), 3e9, -3e9};
+    for (double x : bad) {
+        Rational r(5);
+        std::string printed = captured_cout([&]() { r = Rational::from_double(x); });
+        std::ostringstream what;
+        what << "from_double(" << x << ")";
+        check_value(r, 0, 1, c, what.str());
+        ++c.total;
+        if (printed.find("cant be represented") == std::string::npos) {
+            ++c.failed;
+            std::cerr << "FAIL " << what.str() << ": no error printed\n";
+        }
+    }
+    check_value(Rational::from_double(2147483647.0), 2147483647, 1, c, "from_double(INT_MAX)");
+
+    check_value(Rational(3, 7).limit_denominator(10), 3, 7, c, "limit_denominator(3/7, 10)");
+    check_value(Rational(-3, 7).limit_denominator(7), -3, 7, c, "limit_denominator(-3/7, 7)");
+    check_value(Rational(355, 113).limit_denominator(7), 22, 7, c, "limit_denominator(355/113, 7)");
+    check_value(Rational(-355, 113).limit_denominator(100), -311, 99, c, "limit_denominator(-355/113, 100)");
+    check_value(Rational(1, 1000).limit_denominator(100), 0, 1, c, "limit_denominator(1/1000, 100)");
+    check_value(Rational(0).limit_denominator(1), 0, 1, c, "limit_denominator(0, 1)");
+}
+
+// ----------------------------- RationalMatrix ------------------------------
+static RationalMatrix matrix_of(std::size_t rows, std::size_t cols, const std::vector<Rational> &values) {
+    RationalMatrix m(rows, cols);
+    for (std::size_t r = 0; r < rows; ++r) {
+        for (std::size_t c = 0; c < cols; ++c) m(r, c) = values[r * cols + c];
+    }
+    return m;
+}
+
+static bool is_zero(const RationalMatrix &m) {
+    for (std::size_t r = 0; r < m.rows(); ++r) {
+        for (std::size_t c = 0; c < m.cols(); ++c) {
+            if (m(r, c).numerator() != 0) return false;
+        }
+    }
+    return true;
+}
+
+static bool same(const RationalMatrix &a, const RationalMatrix &b) {
+    if (a.rows() != b.rows() || a.cols() != b.cols()) return false;
+    for (std::size_t r = 0; r < a.rows(); ++r) {
+        for (std::size_t c = 0; c < a.cols(); ++c) {
+            if (a(r, c).numerator() != b(r, c).numerator() || a(r, c).denominator() != b(r, c).denominator()) return false;
+        }
+    }
+    return true;
+}
+
+// Compares the parts, since operator== compares truncated quotients.
+static bool same(const Rational &a, const Rational &b) {
+    return a.numerator() == b.numerator() && a.denominator() == b.denominator();
+}
+
+static void check_true(bool ok, Counters &c, const std::string &what) {
+    ++c.total;
+    if (!ok) {
+        ++c.failed;
+        std::cerr << "FAIL " << what << "\n";
+    }
+}
+
+// Expects f to print an error containing message.
+static void check_error(const std::function<void()> &f, const std::string &message, Counters &c, const std::string &what) {
+    std::string printed = captured_cout(f);
+    check_true(printed.find(message) != std::string::npos, c, what + ": expected '" + message + "', printed '" + printed + "'");
+}
+
+static void check_matrix(Counters &c) {
+    RationalMatrix a = matrix_of(2, 2, {Rational(1), Rational(2), Rational(3), Rational(4)});
+    check_value(a.determinant(), -2, 1, c, "det [[1,2],[3,4]]");
+    RationalMatrix f = matrix_of(2, 2, {Rational(1, 2), Rational(1, 3), Rational(1, 4), Rational(1, 5)});
+    check_value(f.determinant(), 1, 60, c, "det [[1/2,1/3],[1/4,1/5]]");
+    check_value(RationalMatrix().determinant(), 1, 1, c, "det of 0x0");
+
+    RationalMatrix b = matrix_of(2, 2, {Rational(2), Rational(1), Rational(1), Rational(1)});
+    check_true(same(b.inverse(), matrix_of(2, 2, {Rational(1), Rational(-1), Rational(-1), Rational(2)})), c,
+               "inverse [[2,1],[1,1]]");
+    RationalMatrix m = matrix_of(3, 3, {Rational(2), Rational(-1, 2), Rational(0),
+                                        Rational(1, 3), Rational(3), Rational(-1),
+                                        Rational(0), Rational(1, 4), Rational(5, 2)});
+    check_true(same(m * m.inverse(), RationalMatrix::identity(3)), c, "m * inverse(m) == I");
+    check_true(same(m.inverse() * m, RationalMatrix::identity(3)), c, "inverse(m) * m == I");
+
+    // Needs a row swap: the first pivot is zero.
+    RationalMatrix p = matrix_of(3, 3, {Rational(0), Rational(1), Rational(2),
+                                        Rational(1), Rational(0), Rational(3),
+                                        Rational(4), Rational(-3), Rational(8)});
+    check_value(p.determinant(), -2, 1, c, "det with a row swap");
+    std::vector<Rational> x = p.solve({Rational(1, 2), Rational(-1), Rational(2, 3)});
+    RationalMatrix xm(3, 1);
+    for (std::size_t i = 0; i < 3; ++i) xm(i, 0) = x[i];
+    check_true(same(p * xm, matrix_of(3, 1, {Rational(1, 2), Rational(-1), Rational(2, 3)})), c, "p * solve(p, b) == b");
+    x = m.solve({Rational(2), Rational(0), Rational(1)});
+    for (std::size_t i = 0; i < 3; ++i) xm(i, 0) = x[i];
+    check_true(same(m * xm, matrix_of(3, 1, {Rational(2), Rational(0), Rational(1)})), c, "m * solve(m, b) == b");
+
+    // Singular matrices.
+    RationalMatrix s = matrix_of(3, 3, {Rational(1), Rational(2), Rational(3),
+                                        Rational(2), Rational(4), Rational(6),
+                                        Rational(1), Rational(0), Rational(1)});
+    check_value(s.determinant(), 0, 1, c, "det of a singular matrix");
+    RationalMatrix inv;
+    check_error([&]() { inv = s.inverse(); }, "singular", c, "inverse of a singular matrix");
+    check_true(inv.rows() == 3 && is_zero(inv), c, "inverse of a singular matrix is zero");
+    check_error([&]() { x = s.solve({Rational(1), Rational(2), Rational(3)}); }, "singular", c, "solve with a singular matrix");
+    check_true(x.size() == 3 && x[0].numerator() == 0 && x[2].numerator() == 0, c, "solve with a singular matrix gives zeros");
+
+    // Shapes.
+    RationalMatrix wide(2, 3);
+    check_error([&]() { wide.determinant(); }, "square", c, "det of a 2x3 matrix");
+    check_error([&]() { wide.inverse(); }, "square", c, "inverse of a 2x3 matrix");
+    check_error([&]() { m.solve({Rational(1)}); }, "right-hand side", c, "solve with a short right-hand side");
+
+    // Minors of a dense matrix of large entries outgrow 64 bits.
+    std::mt19937 rng(99);
+    RationalMatrix big(12, 12);
+    for (std::size_t r = 0; r < 12; ++r) {
+        for (std::size_t col = 0; col < 12; ++col) big(r, col) = Rational((int)(rng() % 20001) - 10000, 1 + (int)(rng() % 7));
+    }
+    Rational det(5);
+    check_error([&]() { det = big.determinant(); }, "overflows", c, "det overflow");
+    check_value(det, 0, 1, c, "det overflow gives 0");
+    check_error([&]() { inv = big.inverse(); }, "overflows", c, "inverse overflow");
+    check_true(inv.rows() == 12 && is_zero(inv), c, "inverse overflow gives zero");
+    check_error([&]() { x = big.solve(std::vector<Rational>(12, Rational(1))); }, "overflows", c, "solve overflow");
+
+    // The threaded elimination gives the same answers as the serial one.
+    const std::size_t n = 200;
+    RationalMatrix tri(n, n);
+    std::vector<Rational> rhs(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        tri(i, i) = Rational(2);
+        if (i + 1 < n) {
+            tri(i, i + 1) = Rational(-1);
+            tri(i + 1, i) = Rational(-1);
+        }
+        rhs[i] = Rational((int)(i % 5) - 2);
+    }
+    Elimination serial_how, threaded_how;
+    serial_how.threads = 1;
+    threaded_how.threads = 3;
+    threaded_how.parallel_rows = 16;
+    std::vector<Rational> serial = tri.solve(rhs, serial_how);
+    Rational serial_det = tri.determinant(serial_how);
+    std::vector<Rational> threaded = tri.solve(rhs, threaded_how);
+    check_value(tri.determinant(threaded_how), serial_det.numerator(), serial_det.denominator(), c, "threaded det");
+    check_value(serial_det, 201, 1, c, "det of the 200x200 tridiagonal");
+    bool equal = serial.size() == threaded.size();
+    for (std::size_t i = 0; equal && i < n; ++i) equal = same(serial[i], threaded[i]);
+    check_true(equal, c, "threaded solve differs from serial");
+    RationalMatrix xs(n, 1), bs(n, 1);
+    for (std::size_t i = 0; i < n; ++i) {
+        xs(i, 0) = serial[i];
+        bs(i, 0) = rhs[i];
+    }
+    check_true(same(tri * xs, bs), c, "tri * solve(tri, b) == b");
+    RationalMatrix tri_inv = tri.inverse(threaded_how);
+    check_true(same(tri_inv * tri, RationalMatrix::identity(n)), c, "threaded inverse(tri) * tri == I");
+}
+
 // ----------------------------- Main Test Loop -------------------------------
 int main() {
     using T = Rational;
@@ -695,6 +904,9 @@ int main() {
         }
     } // end levels
 
+    check_double_conversions(counters);
+    check_matrix(counters);
+
     // Final summary
     if (counters.failed == 0) {
         std::cout << "\nTest result: PASSED\n";
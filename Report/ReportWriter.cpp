@@ -0,0 +1,150 @@
+#include "ReportWriter.hpp"
+
+#include <charconv>
+#include <cmath>
+
+ReportWriter::ReportWriter(std::ostream& o, ReportFormat format, std::size_t block)
+    : out(o), kind(format), blockSize(block) {
+    buffer.reserve(blockSize + 4096);
+}
+
+ReportWriter::~ReportWriter() { flush(); }
+
+void ReportWriter::flush() {
+    if (buffer.empty()) return;
+    out.write(buffer.data(), buffer.size());
+    out.flush();
+    buffer.clear();
+}
+
+void ReportWriter::maybeFlush() {
+    if (buffer.size() >= blockSize) {
+        out.write(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+}
+
+void ReportWriter::columns(const std::vector<std::string_view>& keys) {
+    if (kind != ReportFormat::Csv) return;
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        if (i) buffer += ',';
+        quoted(keys[i]);
+    }
+    buffer += '\n';
+}
+
+void ReportWriter::beginRecord() {
+    first = true;
+    if (kind == ReportFormat::JsonLines) buffer += '{';
+}
+
+void ReportWriter::endRecord() {
+    switch (kind) {
+        case ReportFormat::Text:      buffer += '\n'; break;
+        case ReportFormat::Csv:       buffer += '\n'; break;
+        case ReportFormat::JsonLines: buffer += "}\n"; break;
+    }
+    maybeFlush();
+}
+
+// Writes what goes before a value: "Key: ", a comma, or "key":.
+void ReportWriter::key(std::string_view k) {
+    switch (kind) {
+        case ReportFormat::Text:
+            buffer += k;
+            buffer += ": ";
+            break;
+        case ReportFormat::Csv:
+            if (!first) buffer += ',';
+            break;
+        case ReportFormat::JsonLines:
+            if (!first) buffer += ',';
+            quoted(k);
+            buffer += ':';
+            break;
+    }
+    first = false;
+}
+
+// CSV quotes only when needed; JSON always, with escapes.
+void ReportWriter::quoted(std::string_view value) {
+    if (kind == ReportFormat::Csv) {
+        if (value.find_first_of(",\"\n\r") == std::string_view::npos) {
+            buffer += value;
+            return;
+        }
+        buffer += '"';
+        for (char c : value) {
+            if (c == '"') buffer += '"';
+            buffer += c;
+        }
+        buffer += '"';
+        return;
+    }
+    static const char hex[] = "0123456789abcdef";
+    buffer += '"';
+    for (char c : value) {
+        unsigned char u = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\') {
+            buffer += '\\';
+            buffer += c;
+        } else if (u < 0x20) {
+            buffer += "\\u00";
+            buffer += hex[u >> 4];
+            buffer += hex[u & 15];
+        } else {
+            buffer += c;
+        }
+    }
+    buffer += '"';
+}
+
+void ReportWriter::field(std::string_view k, std::string_view value) {
+    key(k);
+    if (kind == ReportFormat::Text) buffer += value;
+    else quoted(value);
+    if (kind == ReportFormat::Text) buffer += '\n';
+}
+
+void ReportWriter::number(std::string_view k, const char* begin, const char* end) {
+    key(k);
+    buffer.append(begin, end);
+    if (kind == ReportFormat::Text) buffer += '\n';
+}
+
+void ReportWriter::field(std::string_view k, std::int64_t value) {
+    char digits[24];
+    auto res = std::to_chars(digits, digits + sizeof(digits), value);
+    number(k, digits, res.ptr);
+}
+
+void ReportWriter::field(std::string_view k, std::uint64_t value) {
+    char digits[24];
+    auto res = std::to_chars(digits, digits + sizeof(digits), value);
+    number(k, digits, res.ptr);
+}
+
+void ReportWriter::field(std::string_view k, double value) {
+    // JSON has no nan or inf.
+    if (kind == ReportFormat::JsonLines && !std::isfinite(value)) {
+        static const char null[] = "null";
+        number(k, null, null + 4);
+        return;
+    }
+    char digits[32];
+    auto res = std::to_chars(digits, digits + sizeof(digits), value);
+    number(k, digits, res.ptr);
+}
+
+void ReportWriter::field(std::string_view k, bool value) {
+    if (kind == ReportFormat::Text) {
+        field(k, std::string_view(value ? "yes" : "no"));
+        return;
+    }
+    key(k);
+    buffer += value ? "true" : "false";
+}
+
+void ReportWriter::none(std::string_view k) {
+    if (kind == ReportFormat::Csv) key(k);
+}
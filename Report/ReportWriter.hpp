@@ -0,0 +1,61 @@
+#ifndef REPORTWRITER_HPP
+#define REPORTWRITER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class ReportFormat { Text, Csv, JsonLines };
+
+// Formats records of key/value fields into one reusable buffer and hands it
+// to the stream in large blocks. Numbers go through std::to_chars.
+//   Text       "Key: value" lines, a blank line after each record
+//   Csv        a header row from columns(), then one row per record
+//   JsonLines  one {"key":value,...} object per line; nan and inf are null
+// For CSV every record must give its fields in columns() order; none()
+// leaves a cell empty and is skipped by the other formats.
+class ReportWriter {
+public:
+    explicit ReportWriter(std::ostream& out, ReportFormat format = ReportFormat::Text,
+                          std::size_t blockSize = 1 << 16);
+    ~ReportWriter();
+
+    ReportWriter(const ReportWriter&) = delete;
+    ReportWriter& operator=(const ReportWriter&) = delete;
+
+    ReportFormat format() const { return kind; }
+
+    void columns(const std::vector<std::string_view>& keys);
+
+    void beginRecord();
+    void endRecord();
+
+    void field(std::string_view key, std::string_view value);
+    void field(std::string_view key, const char* value) { field(key, std::string_view(value)); }
+    void field(std::string_view key, const std::string& value) { field(key, std::string_view(value)); }
+    void field(std::string_view key, std::int64_t value);
+    void field(std::string_view key, std::uint64_t value);
+    void field(std::string_view key, int value) { field(key, static_cast<std::int64_t>(value)); }
+    void field(std::string_view key, double value);
+    void field(std::string_view key, bool value);
+    void none(std::string_view key);
+
+    void flush();
+
+private:
+    void key(std::string_view k);
+    void number(std::string_view k, const char* first, const char* last);
+    void quoted(std::string_view value);
+    void maybeFlush();
+
+    std::ostream& out;
+    ReportFormat kind;
+    std::size_t blockSize;
+    std::string buffer;
+    bool first = true;
+};
+
+#endif
@@ -12,7 +12,14 @@ int main() {
        std::cout  << v->type() << std::endl;
     }
 
+    Virtualizable* w = new Derived;
 
+    if (Base* b = dynamicCast<Base>(w)) {
+        std::cout << w->type() << " is a " << b->type() << std::endl;
+    }
+
+    std::vector<Virtualizable*> all = {w, v, w};
+    dispatch_all(all, "foo");
 
     return 0;
 }
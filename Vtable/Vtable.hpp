@@ -1,72 +1,228 @@
+#include <array>
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <iostream>
+#include <type_traits>
+#include <unordered_map>
+
+class Virtualizable;
+
+// Slots hold plain functions taking the object, so no member pointer of
+// one class is ever cast to another.
+using Thunk = void (*)(Virtualizable*);
+
+template <typename T, auto Member>
+void thunk(Virtualizable* self) { (static_cast<T*>(self)->*Member)(); }
+
+template <typename M> struct MemberClass;
+template <typename C> struct MemberClass<void (C::*)()> { using type = C; };
+
+// A type declares its methods once, in the order of Interface::names:
+//     using methods = Methods<Derived, FooBar, &Derived::foo, &Derived::bar>;
+// The dispatch array is constexpr, so calls through it on a known type can
+// be resolved and inlined. Listing a method the type only inherits is a
+// compile error, so every override has to be written out.
+template <typename T, typename Interface, auto... Members>
+struct Methods {
+    static_assert(sizeof...(Members) == Interface::names.size(),
+                  "method list does not match the interface");
+    static_assert((std::is_same_v<typename MemberClass<decltype(Members)>::type, T> && ...),
+                  "missing override: a listed method is inherited, not declared in this type");
+
+    using interface = Interface;
+    static constexpr std::array<Thunk, sizeof...(Members)> dispatch = {&thunk<T, Members>...};
+};
+
+// Per-type dispatch table. Each class defines exactly one during static
+// initialization and it is never modified afterwards; objects only point
+// at it.
+// display[d] is the id of the ancestor at depth d (Cohen's display), with
+// the type itself last, so "is a T" is one bounds check and one compare.
+struct VTable {
+    const char* name;
+    std::vector<Thunk> slots;
+    std::uint32_t id;
+    std::uint32_t depth;
+    std::vector<std::uint32_t> display;
+};
 
 class Virtualizable {
-     std::vector<std::string> names;
 public:
-    using FnPtr = void (Virtualizable::*)();
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
 
-    void registerVirtual(const std::string& name, FnPtr fn) {
-        this->names.push_back(name);
-        this->funcs.push_back(fn);
+    // Method names are interned once into slot ids shared by every type, so
+    // a call is an index into the type's table instead of a string scan.
+    static std::size_t slotOf(const std::string& name) {
+        auto& slots = slotIds();
+        auto it = slots.find(name);
+        if (it != slots.end()) return it->second;
+        return slots.emplace(name, slots.size()).first->second;
     }
-    
-    void callVirtual(const std::string& name) {
-        for (int i = 0; i < names.size(); ++i) {
-            if (names[i] == name) (this->*funcs[i])();
+
+    static std::size_t findSlot(const std::string& name) {
+        auto& slots = slotIds();
+        auto it = slots.find(name);
+        return it == slots.end() ? npos : it->second;
+    }
+
+    // Builds the table of T from T::methods. Slots of methods T does not
+    // declare are inherited from parent, which must already be initialized.
+    template <typename T>
+    static VTable makeTable(const char* name, const VTable* parent) {
+        using M = typename T::methods;
+        static std::uint32_t& nextId = typeCounter();
+
+        VTable table{name, {}, nextId++, 0, {}};
+        if (parent) {
+            table.slots = parent->slots;
+            table.depth = parent->depth + 1;
+            table.display = parent->display;
+        }
+        table.display.push_back(table.id);
+
+        for (std::size_t i = 0; i < M::dispatch.size(); ++i) {
+            std::size_t slot = slotOf(M::interface::names[i]);
+            if (table.slots.size() <= slot) table.slots.resize(slot + 1, nullptr);
+            table.slots[slot] = M::dispatch[i];
         }
+        return table;
     }
-    
-    Virtualizable (const std::string& name, const std::string& funcName1, FnPtr fooPtr, const std::string& funcName2, FnPtr barPtr) : typeid_{name} {
-        registerVirtual(funcName1, fooPtr);
-        registerVirtual(funcName2, barPtr);
+
+    void callVirtual(std::size_t slot) {
+        const std::vector<Thunk>& slots = vtable->slots;
+        if (slot < slots.size() && slots[slot]) slots[slot](this);
     }
-    
+
+    void callVirtual(const std::string& name) {
+        callVirtual(findSlot(name));
+    }
+
+    std::string type() const { return vtable->name; }
+    const VTable* getVTable() const { return vtable; }
+
+    bool isA(const VTable& t) const {
+        return t.depth < vtable->display.size() && vtable->display[t.depth] == t.id;
+    }
+
+protected:
+    explicit Virtualizable(const VTable* table) : vtable(table) {}
+
 private:
-    
-    std::string typeid_;
-    std::vector<FnPtr> funcs;
+    static std::uint32_t& typeCounter() {
+        static std::uint32_t next = 0;
+        return next;
+    }
 
-public:
-    std::string type() { return this->typeid_; }
+    static std::unordered_map<std::string, std::size_t>& slotIds() {
+        static std::unordered_map<std::string, std::size_t> ids;
+        return ids;
+    }
+
+    const VTable* vtable;
 };
 
 
+// Interface shared by Base and Derived.
+struct FooBar {
+    static constexpr std::array<const char*, 2> names = {"foo", "bar"};
+    enum Slot : std::size_t { foo, bar };
+};
+
 class Base : public Virtualizable {
+    static const VTable table;
 
-    std::string typeid_ = "Base";
+protected:
+    explicit Base(const VTable* vt) : Virtualizable(vt) {}
 
 public:
     static std::string type() { return std::string("Base"); }
+    static const VTable& typeTable() { return table; }
     
     void bar() { std::cout << "Base::Bar" << std::endl; }
     void foo() { std::cout << "Base::Foo" << std::endl; }
+
+    using methods = Methods<Base, FooBar, &Base::foo, &Base::bar>;
     
-    Base (const std::string& name = type(), const std::string& funcName1 = "foo", FnPtr fooPtr = (FnPtr)&Base::foo,
-          const std::string& funcName2 = "bar", FnPtr barPtr = (FnPtr)&Base::bar) : Virtualizable(name, funcName1, fooPtr, funcName2, barPtr) {}
+    Base() : Virtualizable(&table) {}
 };
 
+inline const VTable Base::table = Virtualizable::makeTable<Base>("Base", nullptr);
+
 
 class Derived : public Base {
-    std::string typeid_ = "Derived";
+    static const VTable table;
 
 public:
     static std::string type() { return std::string("Derived"); }
+    static const VTable& typeTable() { return table; }
         
     void bar() { std::cout << "Derived::Bar" << std::endl; }
     void foo() { std::cout << "Derived::Foo" << std::endl; }
 
-    Derived (const std::string& name = type(), const std::string& funcName1 = "foo", FnPtr fooPtr = (FnPtr)&Derived::foo,
-             const std::string& funcName2 = "bar", FnPtr barPtr = (FnPtr)&Derived::bar) : Base(name, funcName1, fooPtr, funcName2, barPtr) {}
+    using methods = Methods<Derived, FooBar, &Derived::foo, &Derived::bar>;
+
+    Derived() : Base(&table) {}
 };
 
+inline const VTable Derived::table = Virtualizable::makeTable<Derived>("Derived", &Base::typeTable());
+
+
+// Call through the static type's constexpr dispatch array. With T known
+// the compiler sees the exact thunk and can inline the method.
+template <std::size_t Slot, typename T>
+void callStatic(T& obj) {
+    T::methods::dispatch[Slot](&obj);
+}
+
 
   
+// Succeeds for T and for every base of the object's type, so a Derived can
+// be cast to Base.
 template <typename T>
 T* dynamicCast(Virtualizable* ptr) {
-    if (ptr->type() == T::type())
+    if (ptr && ptr->isA(T::typeTable()))
         return static_cast<T*>(ptr);
 
-        return nullptr;
+    return nullptr;
+}
+
+
+// Calls one method on every object of a container of Virtualizable
+// pointers, grouped by type: objects are bucketed by VTable id, the slot is
+// resolved once per type, and each bucket runs as a loop over a single
+// target. Objects of one type keep their relative order; types run in id
+// order. Objects whose type lacks the method are skipped.
+template <typename Container>
+void dispatch_all(const Container& objs, std::size_t slot) {
+    std::vector<std::size_t> starts;
+    std::vector<const VTable*> tables;
+    for (const Virtualizable* obj : objs) {
+        std::uint32_t id = obj->getVTable()->id;
+        if (starts.size() <= id + 1) {
+            starts.resize(id + 2, 0);
+            tables.resize(id + 1, nullptr);
+        }
+        ++starts[id + 1];
+        tables[id] = obj->getVTable();
+    }
+    for (std::size_t i = 1; i < starts.size(); ++i) starts[i] += starts[i - 1];
+
+    std::vector<Virtualizable*> sorted(starts.empty() ? 0 : starts.back());
+    std::vector<std::size_t> next(starts);
+    for (Virtualizable* obj : objs) sorted[next[obj->getVTable()->id]++] = obj;
+
+    for (std::size_t id = 0; id < tables.size(); ++id) {
+        if (!tables[id] || slot >= tables[id]->slots.size()) continue;
+        Thunk fn = tables[id]->slots[slot];
+        if (!fn) continue;
+        for (std::size_t i = starts[id]; i < starts[id + 1]; ++i) fn(sorted[i]);
+    }
+}
+
+template <typename Container>
+void dispatch_all(const Container& objs, const std::string& method) {
+    std::size_t slot = Virtualizable::findSlot(method);
+    if (slot == Virtualizable::npos) return;
+    dispatch_all(objs, slot);
 }
@@ -0,0 +1,321 @@
+// bench.cpp
+// Benchmarks for the Vtable emulation (C++17)
+// - Call latency: old linear string scan, callVirtual by name (hashed),
+//   callVirtual by interned slot, a native virtual call, and callStatic on
+//   a known type through its constexpr dispatch array.
+// - Construction: sizeof and ns/object for the old per-instance vectors and
+//   strings against one shared VTable pointer, over 10^7 objects.
+// - dynamicCast: casts/s over a mixed Base/Derived/unrelated population,
+//   string comparison of type names against the display check.
+// - dispatch_all: the same method over a shuffled array of four types,
+//   per-object callVirtual against grouped dispatch; time and branch misses
+//   (from perf_event_open where the kernel allows it, n/a otherwise).
+// Build:
+//   g++ -std=c++17 -O2 bench.cpp -o bench
+// Run:
+//   ./bench [calls]
+
+#include "Vtable.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsed_ms(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static void report(const char* name, std::size_t calls, double ms) {
+    std::cout << std::left << std::setw(24) << name
+              << " ns/call=" << ms * 1e6 / calls << std::endl;
+}
+
+static long long sink = 0;
+
+// Makes the compiler assume memory changed, so a loop whose call is inlined
+// still stores to sink on every iteration instead of folding into one add.
+static inline void clobber() { asm volatile("" ::: "memory"); }
+
+// Virtualizable as it was before slot interning: per-object type string,
+// name and function vectors; every call scans all names.
+class LegacyVirtualizable {
+    std::vector<std::string> names;
+    std::vector<void (LegacyVirtualizable::*)()> funcs;
+    std::string typeid_;
+public:
+    using FnPtr = void (LegacyVirtualizable::*)();
+
+    explicit LegacyVirtualizable(const std::string& name) : typeid_{name} {}
+
+    void registerVirtual(const std::string& name, FnPtr fn) {
+        names.push_back(name);
+        funcs.push_back(fn);
+    }
+
+    void callVirtual(const std::string& name) {
+        for (std::size_t i = 0; i < names.size(); ++i) {
+            if (names[i] == name) (this->*funcs[i])();
+        }
+    }
+};
+
+class LegacyCounter : public LegacyVirtualizable {
+    std::string typeid_ = "LegacyCounter";
+public:
+    void foo() { ++sink; }
+    void bar() { --sink; }
+    LegacyCounter(const std::string& name = "LegacyCounter") : LegacyVirtualizable(name) {
+        registerVirtual("foo", (FnPtr)&LegacyCounter::foo);
+        registerVirtual("bar", (FnPtr)&LegacyCounter::bar);
+    }
+};
+
+class SlotCounter : public Virtualizable {
+    static const VTable table;
+public:
+    void foo() { ++sink; }
+    void bar() { --sink; }
+    using methods = Methods<SlotCounter, FooBar, &SlotCounter::foo, &SlotCounter::bar>;
+    SlotCounter() : Virtualizable(&table) {}
+};
+
+const VTable SlotCounter::table = Virtualizable::makeTable<SlotCounter>("SlotCounter", nullptr);
+
+// Four unrelated types for the dispatch_all population.
+template <int K>
+class Tally : public Virtualizable {
+    static const VTable table;
+public:
+    void foo() { sink += K; }
+    void bar() { sink -= K; }
+    using methods = Methods<Tally, FooBar, &Tally::foo, &Tally::bar>;
+    Tally() : Virtualizable(&table) {}
+};
+
+template <int K>
+const VTable Tally<K>::table = Virtualizable::makeTable<Tally<K>>("Tally", nullptr);
+
+// Branch misses of the calling thread; reads -1 when perf is unavailable.
+class BranchMisses {
+    int fd = -1;
+public:
+    BranchMisses() {
+#ifdef __linux__
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+    ~BranchMisses() {
+#ifdef __linux__
+        if (fd >= 0) close(fd);
+#endif
+    }
+    void start() {
+#ifdef __linux__
+        if (fd < 0) return;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+    long long stop() {
+#ifdef __linux__
+        if (fd < 0) return -1;
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        long long count = 0;
+        if (read(fd, &count, sizeof(count)) != sizeof(count)) return -1;
+        return count;
+#else
+        return -1;
+#endif
+    }
+};
+
+static void report_misses(const char* name, std::size_t calls, double ms, long long misses) {
+    std::cout << std::left << std::setw(24) << name << " ns/call=" << std::setw(10) << ms * 1e6 / calls;
+    if (misses < 0) std::cout << " branch-misses=n/a" << std::endl;
+    else std::cout << " branch-misses/call=" << static_cast<double>(misses) / calls << std::endl;
+}
+
+static void bench_dispatch_all(std::size_t calls) {
+    const std::size_t objects = 1 << 16;
+    std::vector<Tally<1>> t1;
+    std::vector<Tally<2>> t2;
+    std::vector<Tally<3>> t3;
+    std::vector<Tally<4>> t4;
+    t1.reserve(objects); t2.reserve(objects); t3.reserve(objects); t4.reserve(objects);
+
+    std::vector<Virtualizable*> mixed;
+    std::mt19937 rng(17);
+    for (std::size_t i = 0; i < objects; ++i) {
+        switch (rng() % 4) {
+            case 0: mixed.push_back(&t1.emplace_back()); break;
+            case 1: mixed.push_back(&t2.emplace_back()); break;
+            case 2: mixed.push_back(&t3.emplace_back()); break;
+            default: mixed.push_back(&t4.emplace_back()); break;
+        }
+    }
+
+    std::size_t rounds = calls / objects ? calls / objects : 1;
+    std::size_t slot = Virtualizable::slotOf("foo");
+    BranchMisses counter;
+
+    counter.start();
+    auto start = Clock::now();
+    for (std::size_t r = 0; r < rounds; ++r)
+        for (Virtualizable* obj : mixed) obj->callVirtual(slot);
+    double ms = elapsed_ms(start);
+    report_misses("per-object callVirtual", rounds * objects, ms, counter.stop());
+
+    counter.start();
+    start = Clock::now();
+    for (std::size_t r = 0; r < rounds; ++r) dispatch_all(mixed, slot);
+    ms = elapsed_ms(start);
+    report_misses("dispatch_all", rounds * objects, ms, counter.stop());
+}
+
+struct NativeBase {
+    virtual void foo() = 0;
+    virtual ~NativeBase() = default;
+};
+
+struct NativeCounter : NativeBase {
+    void foo() override { ++sink; }
+};
+
+// Legacy objects are built and destroyed in place in a small ring, since
+// 10^7 of them with their heap vectors would not fit in memory.
+static void bench_construction(std::size_t count) {
+    const std::size_t ring = 1024;
+    std::vector<LegacyCounter> legacy(ring);
+    auto start = Clock::now();
+    for (std::size_t i = 0; i < count; ++i) {
+        LegacyCounter* slot = &legacy[i % ring];
+        slot->~LegacyCounter();
+        new (slot) LegacyCounter();
+    }
+    double legacy_ms = elapsed_ms(start);
+
+    start = Clock::now();
+    std::vector<SlotCounter> shared(count);
+    double shared_ms = elapsed_ms(start);
+
+    std::cout << "legacy objects   sizeof=" << std::setw(4) << sizeof(LegacyCounter)
+              << " ns/object=" << legacy_ms * 1e6 / count << std::endl;
+    std::cout << "VTable objects   sizeof=" << std::setw(4) << sizeof(SlotCounter)
+              << " ns/object=" << shared_ms * 1e6 / count
+              << " (" << shared.size() * sizeof(SlotCounter) / (1 << 20) << " MiB total)" << std::endl;
+}
+
+// dynamicCast as it was: exact type only, by comparing name strings.
+template <typename T>
+T* legacyCast(Virtualizable* ptr) {
+    if (ptr->type() == T::type()) return static_cast<T*>(ptr);
+    return nullptr;
+}
+
+template <typename T>
+static void bench_cast(const char* name, const std::vector<Virtualizable*>& objs, std::size_t calls) {
+    std::size_t n = objs.size();
+    std::size_t legacy_hits = 0, hits = 0;
+
+    auto start = Clock::now();
+    for (std::size_t i = 0; i < calls; ++i) legacy_hits += legacyCast<T>(objs[i % n]) != nullptr;
+    double legacy_ms = elapsed_ms(start);
+
+    start = Clock::now();
+    for (std::size_t i = 0; i < calls; ++i) hits += dynamicCast<T>(objs[i % n]) != nullptr;
+    double ms = elapsed_ms(start);
+
+    std::cout << "cast to " << std::left << std::setw(8) << name
+              << " string Mcasts/s=" << std::setw(10) << calls / (legacy_ms * 1000.0)
+              << " display Mcasts/s=" << std::setw(10) << calls / (ms * 1000.0)
+              << " hits " << legacy_hits << " vs " << hits << std::endl;
+}
+
+int main(int argc, char** argv) {
+    std::size_t calls = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    const std::size_t objects = 1024;
+
+    std::vector<std::unique_ptr<LegacyCounter>> legacy;
+    std::vector<std::unique_ptr<SlotCounter>> slotted;
+    std::vector<std::unique_ptr<NativeBase>> native;
+    for (std::size_t i = 0; i < objects; ++i) {
+        legacy.push_back(std::make_unique<LegacyCounter>());
+        slotted.push_back(std::make_unique<SlotCounter>());
+        native.push_back(std::make_unique<NativeCounter>());
+    }
+    const std::string foo = "foo";
+
+    auto start = Clock::now();
+    for (std::size_t i = 0; i < calls; ++i) legacy[i % objects]->callVirtual(foo);
+    report("legacy string scan", calls, elapsed_ms(start));
+
+    start = Clock::now();
+    for (std::size_t i = 0; i < calls; ++i) slotted[i % objects]->callVirtual(foo);
+    report("callVirtual(name)", calls, elapsed_ms(start));
+
+    std::size_t slot = Virtualizable::slotOf("foo");
+    start = Clock::now();
+    for (std::size_t i = 0; i < calls; ++i) slotted[i % objects]->callVirtual(slot);
+    report("callVirtual(slot)", calls, elapsed_ms(start));
+
+    start = Clock::now();
+    for (std::size_t i = 0; i < calls; ++i) native[i % objects]->foo();
+    report("native virtual", calls, elapsed_ms(start));
+
+    start = Clock::now();
+    for (std::size_t i = 0; i < calls; ++i) {
+        callStatic<FooBar::foo>(*slotted[i % objects]);
+        clobber();
+    }
+    report("callStatic (known type)", calls, elapsed_ms(start));
+
+    bench_construction(calls);
+
+    // Reserved up front so the pointers in mixed stay valid.
+    std::vector<Base> bases;
+    std::vector<Derived> deriveds;
+    std::vector<SlotCounter> others;
+    bases.reserve(objects);
+    deriveds.reserve(objects);
+    others.reserve(objects);
+
+    std::vector<Virtualizable*> mixed;
+    std::mt19937 rng(9);
+    for (std::size_t i = 0; i < objects; ++i) {
+        switch (rng() % 3) {
+            case 0: mixed.push_back(&bases.emplace_back()); break;
+            case 1: mixed.push_back(&deriveds.emplace_back()); break;
+            default: mixed.push_back(&others.emplace_back()); break;
+        }
+    }
+    bench_cast<Base>("Base", mixed, calls);
+    bench_cast<Derived>("Derived", mixed, calls);
+
+    bench_dispatch_all(calls);
+
+    std::cout << "(checksum " << sink << ")" << std::endl;
+    return 0;
+}
@@ -0,0 +1,92 @@
+#include "WorkStealingPool.hpp"
+
+WorkStealingPool::WorkStealingPool(unsigned threads)
+    : count(threads ? threads : 1), queues(new Queue[threads ? threads : 1]) {
+    for (unsigned i = 1; i < count; ++i) workers.emplace_back(&WorkStealingPool::work, this, i);
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lk(m);
+        stop = true;
+    }
+    wake.notify_all();
+    for (std::thread& t : workers) t.join();
+}
+
+void WorkStealingPool::run(std::size_t tasks, const std::function<void(std::size_t)>& task) {
+    run(tasks, std::function<void(std::size_t, unsigned)>([&task](std::size_t i, unsigned) { task(i); }));
+}
+
+void WorkStealingPool::run(std::size_t tasks, const std::function<void(std::size_t, unsigned)>& task) {
+    if (tasks == 0) return;
+    if (count == 1) {
+        for (std::size_t i = 0; i < tasks; ++i) task(i, 0);
+        return;
+    }
+
+    remaining.store(tasks);
+    {
+        std::lock_guard<std::mutex> lk(m);
+        job = &task;
+        for (unsigned q = 0; q < count; ++q) {
+            std::size_t begin = tasks * q / count, end = tasks * (q + 1) / count;
+            std::lock_guard<std::mutex> ql(queues[q].lock);
+            for (std::size_t i = begin; i < end; ++i) queues[q].items.push_back(i);
+        }
+        ++generation;
+    }
+    wake.notify_all();
+
+    drain(0);
+    std::unique_lock<std::mutex> lk(m);
+    finished.wait(lk, [&] { return remaining.load() == 0; });
+    job = nullptr;
+}
+
+void WorkStealingPool::work(unsigned self) {
+    std::size_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lk(m);
+            wake.wait(lk, [&] { return stop || generation != seen; });
+            if (stop) return;
+            seen = generation;
+        }
+        drain(self);
+    }
+}
+
+void WorkStealingPool::drain(unsigned self) {
+    std::size_t task;
+    while (next(self, task)) {
+        (*job)(task, self);
+        if (remaining.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> lk(m);
+            finished.notify_all();
+        }
+    }
+}
+
+// Own queue from the front, then the others' from the back.
+bool WorkStealingPool::next(unsigned self, std::size_t& task) {
+    {
+        Queue& own = queues[self];
+        std::lock_guard<std::mutex> lk(own.lock);
+        if (!own.items.empty()) {
+            task = own.items.front();
+            own.items.pop_front();
+            return true;
+        }
+    }
+    for (unsigned i = 1; i < count; ++i) {
+        Queue& victim = queues[(self + i) % count];
+        std::lock_guard<std::mutex> lk(victim.lock);
+        if (!victim.items.empty()) {
+            task = victim.items.back();
+            victim.items.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,58 @@
+#ifndef WORKSTEALINGPOOL_HPP
+#define WORKSTEALINGPOOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of threads running numbered tasks. run() deals the tasks out as
+// contiguous ranges, one per thread; a thread works its own range from the
+// front and, once empty, steals from the back of the others.
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(unsigned threads = std::thread::hardware_concurrency());
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // Number of threads working a run, the calling thread included.
+    unsigned size() const { return count; }
+
+    // Calls task(i) for every i in [0, tasks) and returns when all are done.
+    void run(std::size_t tasks, const std::function<void(std::size_t)>& task);
+
+    // As above, also passing the index in [0, size()) of the thread running
+    // the task, for per-thread state.
+    void run(std::size_t tasks, const std::function<void(std::size_t, unsigned)>& task);
+
+private:
+    struct alignas(64) Queue {
+        std::mutex lock;
+        std::deque<std::size_t> items;
+    };
+
+    void work(unsigned self);
+    bool next(unsigned self, std::size_t& task);
+    void drain(unsigned self);
+
+    unsigned count;
+    std::unique_ptr<Queue[]> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex m;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    const std::function<void(std::size_t, unsigned)>* job = nullptr;
+    std::size_t generation = 0;
+    std::atomic<std::size_t> remaining{0};
+    bool stop = false;
+};
+
+#endif
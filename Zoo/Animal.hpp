@@ -1,32 +1,34 @@
+#ifndef ANIMAL_HPP
+#define ANIMAL_HPP
+
 #include <iostream>
 #include <vector>
-
-enum class Kind {
-    Animal, Mammal, Bird, Reptile,
-    Lion, Tiger, Elephant,
-    Eagle, Parrot,
-    Snake, Crocodile
-};
+#include "ZooWorld.hpp"
 
 class Animal;
 
-class Counter{ 
-    inline static int id; 
-    friend class Animal;
-};
-
+// A view of one animal in a ZooWorld. Constructing an animal adds it to
+// ZooWorld::global(); copies refer to the same animal.
 class Animal{
 protected:
-    std::string name;
-    size_t health;     // 0..100
-    size_t hunger;     // 0..100
-    Kind _kind;
-    int id;
+    ZooWorld* world;
+    AnimalHandle handle;
+
+    Animal(Kind kind, std::string aname);
+    SpeciesPool& pool() const { return world->pool(handle.kind); }
+    std::size_t row() const { return world->row(handle); }
 public:
     Animal();
     Animal(std::string aname);
+    Animal(ZooWorld& w, AnimalHandle h);
     void PrintInfo() const;
     void Feed();
     Kind KindOf() const;
-    int Id() const;
-};
\ No newline at end of file
+    std::uint64_t Id() const;
+    Symbol Name() const;
+    size_t Health() const;
+    size_t Hunger() const;
+    AnimalHandle Handle() const;
+};
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef ANIMALREF_HPP
+#define ANIMALREF_HPP
+
+#include "Zoo.hpp"
+
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+// A species animal as one closed type: std::visit reaches Roar, Jump,
+// Soar, ... without a cast or a switch on Kind. Alternatives are the views
+// from Zoo.hpp, so an AnimalRef is small and refers to the world's animal.
+using AnimalRef = std::variant<Lion, Tiger, Elephant, Eagle, Parrot, Snake, Crocodile>;
+
+template <typename... Fs>
+struct overloaded : Fs... {
+    using Fs::operator()...;
+};
+template <typename... Fs>
+overloaded(Fs...) -> overloaded<Fs...>;
+
+// The typed view of an animal; empty for the generic kinds (Animal,
+// Mammal, Bird, Reptile), which have no alternative.
+inline std::optional<AnimalRef> makeRef(ZooWorld& world, AnimalHandle h) {
+    switch (h.kind) {
+        case Kind::Lion:      return AnimalRef(std::in_place_type<Lion>, world, h);
+        case Kind::Tiger:     return AnimalRef(std::in_place_type<Tiger>, world, h);
+        case Kind::Elephant:  return AnimalRef(std::in_place_type<Elephant>, world, h);
+        case Kind::Eagle:     return AnimalRef(std::in_place_type<Eagle>, world, h);
+        case Kind::Parrot:    return AnimalRef(std::in_place_type<Parrot>, world, h);
+        case Kind::Snake:     return AnimalRef(std::in_place_type<Snake>, world, h);
+        case Kind::Crocodile: return AnimalRef(std::in_place_type<Crocodile>, world, h);
+        default:              return std::nullopt;
+    }
+}
+
+inline void printInfo(const AnimalRef& ref) {
+    std::visit([](const auto& a) { a.PrintInfo(); }, ref);
+}
+
+// The species' own ability: Roar, Jump, UseTrunk, Soar, Speak, Hiss, Snap.
+inline void act(AnimalRef& ref) {
+    std::visit(overloaded{
+        [](Lion& a) { a.Roar(); },
+        [](Tiger& a) { a.Jump(); },
+        [](Elephant& a) { a.UseTrunk(); },
+        [](Eagle& a) { a.Soar(); },
+        [](Parrot& a) { a.Speak(); },
+        [](Snake& a) { a.Hiss(); },
+        [](Crocodile& a) { a.Snap(); },
+    }, ref);
+}
+
+// AnimalRefs split into one contiguous vector per alternative. visit runs
+// one typed loop per species, so the call inside is resolved statically.
+class AnimalRefs {
+public:
+    void push_back(const AnimalRef& ref) {
+        std::visit([this](const auto& a) { of<std::decay_t<decltype(a)>>().push_back(a); }, ref);
+    }
+
+    // Adds every species animal of the world.
+    void add(ZooWorld& world) {
+        for (std::size_t k = 0; k < kindCount; ++k) {
+            Kind kind = static_cast<Kind>(k);
+            for (std::size_t r = 0; r < world.pool(kind).size(); ++r) {
+                if (std::optional<AnimalRef> ref = makeRef(world, world.handleAt(kind, r))) push_back(*ref);
+            }
+        }
+    }
+
+    template <typename T>
+    std::vector<T>& of() { return std::get<std::vector<T>>(lists); }
+
+    template <typename T>
+    const std::vector<T>& of() const { return std::get<std::vector<T>>(lists); }
+
+    std::size_t size() const {
+        return std::apply([](const auto&... v) { return (v.size() + ...); }, lists);
+    }
+
+    // Calls f on every element, species by species in variant order.
+    template <typename F>
+    void visit(F&& f) {
+        std::apply([&](auto&... v) { (visitAll(v, f), ...); }, lists);
+    }
+
+private:
+    template <typename V, typename F>
+    static void visitAll(V& v, F& f) {
+        for (auto& a : v) f(a);
+    }
+
+    std::tuple<std::vector<Lion>, std::vector<Tiger>, std::vector<Elephant>, std::vector<Eagle>,
+               std::vector<Parrot>, std::vector<Snake>, std::vector<Crocodile>> lists;
+};
+
+#endif
@@ -0,0 +1,147 @@
+#include "Symbols.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t shardCount = 16;
+constexpr std::size_t blockSize = 16 * 1024;
+constexpr std::uint64_t symbolLimit = std::uint64_t(1) << 32;
+
+// Symbol -> string in pages of 2^16 entries, allocated as ids reach them.
+constexpr std::size_t pageBits = 16;
+constexpr std::size_t pageSize = std::size_t(1) << pageBits;
+constexpr std::size_t pageCount = std::size_t(1) << (32 - pageBits);
+
+// The strings of one shard and their symbols. Bytes are copied into blocks
+// that are never freed, so the map's keys and str() views stay valid.
+struct Shard {
+    std::shared_mutex mutex;
+    std::unordered_map<std::string_view, std::uint32_t> index;
+    std::vector<std::unique_ptr<char[]>> blocks;
+    char* cursor = nullptr;
+    std::size_t left = 0;
+    std::size_t arenaBytes = 0;
+
+    std::string_view store(std::string_view s) {
+        char* at;
+        if (s.size() > blockSize / 4) {
+            blocks.emplace_back(new char[s.size()]);
+            arenaBytes += s.size();
+            at = blocks.back().get();
+        } else {
+            if (left < s.size()) {
+                blocks.emplace_back(new char[blockSize]);
+                arenaBytes += blockSize;
+                cursor = blocks.back().get();
+                left = blockSize;
+            }
+            at = cursor;
+            cursor += s.size();
+            left -= s.size();
+        }
+        std::memcpy(at, s.data(), s.size());
+        return std::string_view(at, s.size());
+    }
+};
+
+struct Table {
+    Table() { pages[0].store(new std::string_view[pageSize](), std::memory_order_relaxed); }
+
+    std::string_view& entry(std::uint32_t id) {
+        std::atomic<std::string_view*>& page = pages[id >> pageBits];
+        std::string_view* p = page.load(std::memory_order_acquire);
+        if (!p) {
+            std::lock_guard<std::mutex> lock(pagesMutex);
+            p = page.load(std::memory_order_relaxed);
+            if (!p) {
+                p = new std::string_view[pageSize]();
+                page.store(p, std::memory_order_release);
+                pagesAllocated.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        return p[id & (pageSize - 1)];
+    }
+
+    alignas(64) Shard shards[shardCount];
+    std::atomic<std::string_view*> pages[pageCount] = {};
+    std::mutex pagesMutex;
+    std::atomic<std::size_t> pagesAllocated{1};
+    alignas(64) std::atomic<std::uint64_t> next{1};
+};
+
+Table& table() {
+    static Table t;
+    return t;
+}
+
+Shard& shardOf(Table& t, std::string_view s) {
+    return t.shards[std::hash<std::string_view>()(s) % shardCount];
+}
+
+}
+
+// Lookups of known strings take the shard's lock shared; only a new string
+// takes it exclusively.
+Symbol Symbols::intern(std::string_view s) {
+    if (s.empty()) return Symbol();
+    Table& t = table();
+    Shard& shard = shardOf(t, s);
+    {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.index.find(s);
+        if (it != shard.index.end()) return Symbol(it->second);
+    }
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.index.find(s);
+    if (it != shard.index.end()) return Symbol(it->second);
+
+    std::uint64_t id = t.next.fetch_add(1, std::memory_order_relaxed);
+    if (id >= symbolLimit) {
+        std::cout << "Out of symbols!" << std::endl;
+        return Symbol();
+    }
+    std::string_view stored = shard.store(s);
+    t.entry(static_cast<std::uint32_t>(id)) = stored;
+    shard.index.emplace(stored, static_cast<std::uint32_t>(id));
+    return Symbol(static_cast<std::uint32_t>(id));
+}
+
+Symbol Symbols::find(std::string_view s) {
+    if (s.empty()) return Symbol();
+    Shard& shard = shardOf(table(), s);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.index.find(s);
+    return it != shard.index.end() ? Symbol(it->second) : Symbol();
+}
+
+std::string_view Symbols::str(Symbol s) {
+    std::string_view* page = table().pages[s.id >> pageBits].load(std::memory_order_acquire);
+    return page ? page[s.id & (pageSize - 1)] : std::string_view();
+}
+
+std::size_t Symbols::size() {
+    std::uint64_t n = table().next.load(std::memory_order_relaxed);
+    return static_cast<std::size_t>(n < symbolLimit ? n : symbolLimit);
+}
+
+std::size_t Symbols::bytes() {
+    Table& t = table();
+    const std::size_t node = sizeof(void*) + sizeof(std::pair<const std::string_view, std::uint32_t>) + sizeof(std::size_t);
+    std::size_t total = sizeof(t.pages) + t.pagesAllocated.load(std::memory_order_relaxed) * pageSize * sizeof(std::string_view);
+    for (Shard& shard : t.shards) {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        total += shard.arenaBytes + shard.index.bucket_count() * sizeof(void*) + shard.index.size() * node;
+    }
+    return total;
+}
+
+std::ostream& operator<<(std::ostream& out, Symbol s) { return out << Symbols::str(s); }
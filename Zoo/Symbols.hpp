@@ -0,0 +1,44 @@
+#ifndef SYMBOLS_HPP
+#define SYMBOLS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string_view>
+
+// A 32-bit handle for an interned string. Equal strings get equal symbols,
+// so comparing two names is one integer compare. Symbol{} is "".
+struct Symbol {
+    std::uint32_t id = 0;
+
+    Symbol() = default;
+    explicit Symbol(std::uint32_t i) : id(i) {}
+
+    bool operator==(Symbol other) const { return id == other.id; }
+    bool operator!=(Symbol other) const { return id != other.id; }
+};
+
+// The process-wide string interner, safe to use from any thread.
+// Strings are hashed into shards, each with its own lock, and copied once
+// into the shard's arena, so their bytes never move. Symbol to string goes
+// through a paged table and takes no lock.
+class Symbols {
+public:
+    static Symbol intern(std::string_view s);
+
+    // The symbol of s if it was interned before; Symbol{} otherwise.
+    static Symbol find(std::string_view s);
+
+    // The string of a symbol; valid for the life of the program.
+    static std::string_view str(Symbol s);
+
+    // Distinct strings interned so far, counting "".
+    static std::size_t size();
+
+    // Memory held by the interner: string bytes, hash maps and the table.
+    static std::size_t bytes();
+};
+
+std::ostream& operator<<(std::ostream& out, Symbol s);
+
+#endif
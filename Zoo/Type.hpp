@@ -5,28 +5,33 @@
 
 class Mammal : public Animal{
 protected:
-    bool warmBlooded = true;
+    static constexpr bool warmBlooded = true;
+    Mammal(Kind kind, std::string aname);
 public:
     Mammal();
     Mammal(std::string aname);
+    Mammal(ZooWorld& w, AnimalHandle h);
     void makesound();
 };
 
 class Bird : public Animal {
 protected:
-    double wingSpan;
+    Bird(Kind kind, std::string aname, double wS = 75.4);
 public:
     Bird();
     Bird(std::string aname, double wS = 75.4);
+    Bird(ZooWorld& w, AnimalHandle h);
     void Fly();    
 };
 
 class Reptile : public Animal{
 protected:
-    bool coldBlooded = true;
+    static constexpr bool coldBlooded = true;
+    Reptile(Kind kind, std::string aname);
 public:
     Reptile();
     Reptile(std::string name);
+    Reptile(ZooWorld& w, AnimalHandle h);
     void Sunbathe(); 
 };
 
@@ -1,82 +1,88 @@
 #include "Zoo.hpp"
+#include "ZooIndex.hpp"
+
+#include <algorithm>
+#include <cmath>
 
 // Animal
-Animal::Animal() : health(100), hunger(0), name("Unknown"), _kind(Kind::Animal) { 
-    this->id = ++Counter::id; 
-} 
+Animal::Animal() : Animal(Kind::Animal, "Unknown") {} 
+
+Animal::Animal(std::string aname) : Animal(Kind::Animal, aname) {}
 
-Animal::Animal(std::string aname) : health(100), hunger(0), name(aname), _kind(Kind::Animal) { 
-    this->id = ++Counter::id; 
+Animal::Animal(Kind kind, std::string aname) : world(&ZooWorld::global()) {
+    handle = world->add(kind, aname);
 }
 
+Animal::Animal(ZooWorld& w, AnimalHandle h) : world(&w), handle(h) {}
+
 void Lion::PrintInfo() const{
-    std::cout << "Name: " << name << std::endl;
-    std::cout << "Animal class: Mamal" << std::endl;
-    std::cout << "Animal species: Lion" << std::endl;
-    std::cout << "Roar" << roarPower << std::endl;
-    std::cout << "Hunger: " << hunger << std::endl;
-    std::cout << "Health: " << health << std::endl;
-    std::cout << "id: " << id << std::endl;
+    std::cout << "Name: " << Name() << '\n';
+    std::cout << "Animal class: Mamal" << '\n';
+    std::cout << "Animal species: Lion" << '\n';
+    std::cout << "Roar" << pool().roarPower[row()] << '\n';
+    std::cout << "Hunger: " << Hunger() << '\n';
+    std::cout << "Health: " << Health() << '\n';
+    std::cout << "id: " << Id() << '\n';
 }
 
 void Tiger::PrintInfo() const{
-    std::cout << "Name: " << name << std::endl;
-    std::cout << "Animal class: Mamal" << std::endl;
-    std::cout << "Animal species: Tiger" << std::endl;
-    std::cout << "Jump Height: " << jumpHeight << std::endl;
-    std::cout << "Hunger: " << hunger << std::endl;
-    std::cout << "Health: " << health << std::endl;
-    std::cout << "id: " << id << std::endl;
+    std::cout << "Name: " << Name() << '\n';
+    std::cout << "Animal class: Mamal" << '\n';
+    std::cout << "Animal species: Tiger" << '\n';
+    std::cout << "Jump Height: " << pool().jumpHeight[row()] << '\n';
+    std::cout << "Hunger: " << Hunger() << '\n';
+    std::cout << "Health: " << Health() << '\n';
+    std::cout << "id: " << Id() << '\n';
 }
 
 void Elephant::PrintInfo() const{
-    std::cout << "Name: " << name << std::endl;
-    std::cout << "Animal class: Mamal" << std::endl;
-    std::cout << "Animal species: Elephant" << std::endl;
-    std::cout << "Trunk length: " << trunkLength << std::endl;
-    std::cout << "Hunger: " << hunger << std::endl;
-    std::cout << "Health: " << health << std::endl;
-    std::cout << "id: " << id << std::endl;
+    std::cout << "Name: " << Name() << '\n';
+    std::cout << "Animal class: Mamal" << '\n';
+    std::cout << "Animal species: Elephant" << '\n';
+    std::cout << "Trunk length: " << pool().trunkLength[row()] << '\n';
+    std::cout << "Hunger: " << Hunger() << '\n';
+    std::cout << "Health: " << Health() << '\n';
+    std::cout << "id: " << Id() << '\n';
 }
 
 void Snake::PrintInfo() const{
-    std::cout << "Name: " << name << std::endl;
-    std::cout << "Animal class: Reptile" << std::endl;
-    std::cout << "Animal species: Snake" << std::endl;
-    std::cout << "Hunger: " << hunger << std::endl;
-    std::cout << "Health: " << health << std::endl;
-    std::cout << "id: " << id << std::endl;
+    std::cout << "Name: " << Name() << '\n';
+    std::cout << "Animal class: Reptile" << '\n';
+    std::cout << "Animal species: Snake" << '\n';
+    std::cout << "Hunger: " << Hunger() << '\n';
+    std::cout << "Health: " << Health() << '\n';
+    std::cout << "id: " << Id() << '\n';
 }
 
 void Crocodile::PrintInfo() const{
-    std::cout << "Name: " << name << std::endl;
-    std::cout << "Animal class: Reptile" << std::endl;
-    std::cout << "Animal species: Crocodile" << std::endl;
-    std::cout << "Bite force " << biteForce << std::endl;
-    std::cout << "Hunger: " << hunger << std::endl;
-    std::cout << "Health: " << health << std::endl;
-    std::cout << "id: " << id << std::endl;
+    std::cout << "Name: " << Name() << '\n';
+    std::cout << "Animal class: Reptile" << '\n';
+    std::cout << "Animal species: Crocodile" << '\n';
+    std::cout << "Bite force " << pool().biteForce[row()] << '\n';
+    std::cout << "Hunger: " << Hunger() << '\n';
+    std::cout << "Health: " << Health() << '\n';
+    std::cout << "id: " << Id() << '\n';
 }
 
 void Eagle::PrintInfo() const{
-    std::cout << "Name: " << name << std::endl;
-    std::cout << "Animal class: Bird" << std::endl;
-    std::cout << "Animal species: Eagle" << std::endl;
-    std::cout << "VisionRange " << visionRange << std::endl;
-    std::cout << "Wingspan" << wingSpan << std::endl;
-    std::cout << "Hunger: " << hunger << std::endl;
-    std::cout << "Health: " << health << std::endl;
-    std::cout << "id: " << id << std::endl;
+    std::cout << "Name: " << Name() << '\n';
+    std::cout << "Animal class: Bird" << '\n';
+    std::cout << "Animal species: Eagle" << '\n';
+    std::cout << "VisionRange " << pool().visionRange[row()] << '\n';
+    std::cout << "Wingspan" << pool().wingSpan[row()] << '\n';
+    std::cout << "Hunger: " << Hunger() << '\n';
+    std::cout << "Health: " << Health() << '\n';
+    std::cout << "id: " << Id() << '\n';
 }
 
 void Parrot::PrintInfo() const{
-    std::cout << "Name: " << name << std::endl;
-    std::cout << "Animal class: Bird" << std::endl;
-    std::cout << "Animal species: Parrot" << std::endl;
-    std::cout << "Wingspan" << wingSpan << std::endl;
-    std::cout << "Hunger: " << hunger << std::endl;
-    std::cout << "Health: " << health << std::endl;
-    std::cout << "id: " << id << std::endl;
+    std::cout << "Name: " << Name() << '\n';
+    std::cout << "Animal class: Bird" << '\n';
+    std::cout << "Animal species: Parrot" << '\n';
+    std::cout << "Wingspan" << pool().wingSpan[row()] << '\n';
+    std::cout << "Hunger: " << Hunger() << '\n';
+    std::cout << "Health: " << Health() << '\n';
+    std::cout << "id: " << Id() << '\n';
 }
 
 void Animal::PrintInfo() const {
@@ -115,164 +121,329 @@ void Animal::PrintInfo() const {
 }
 
 void Animal::Feed() {
-    if(hunger == 0 || health == 100) {
+    if(!world->feed(handle)) {
         std::cout << "Animal is not hungry!" << std::endl;
         return;
     }
     std::cout << "Nom. Nom. Nom..." << std::endl;
-    hunger = 0;
-    health = 100;
 }
 
-Kind Animal::KindOf() const { return _kind; }
-int Animal::Id() const { return this->id; }
+Kind Animal::KindOf() const { return handle.kind; }
+std::uint64_t Animal::Id() const { return pool().id[row()]; }
+Symbol Animal::Name() const { return pool().name[row()]; }
+size_t Animal::Health() const { return pool().health[row()]; }
+size_t Animal::Hunger() const { return pool().hunger[row()]; }
+AnimalHandle Animal::Handle() const { return handle; }
 
 // Mammal
-Mammal::Mammal() : Animal() { 
-    _kind = Kind::Mammal;
-}
+Mammal::Mammal() : Animal(Kind::Mammal, "Unknown") {}
 
-Mammal::Mammal(std::string aname) : Animal(aname) { 
-    _kind = Kind::Mammal;
-}
+Mammal::Mammal(std::string aname) : Animal(Kind::Mammal, aname) {}
+
+Mammal::Mammal(Kind kind, std::string aname) : Animal(kind, aname) {}
+
+Mammal::Mammal(ZooWorld& w, AnimalHandle h) : Animal(w, h) {}
 
 void Mammal::makesound() { std::cout << "Brrr" << std::endl; }
 
 // Bird
-Bird::Bird() : Animal() { 
-    _kind = Kind::Bird;
-    wingSpan = 75.4;
-}
+Bird::Bird() : Bird(Kind::Bird, "Unknown") {}
+
+Bird::Bird(std::string aname, double wS) : Bird(Kind::Bird, aname, wS) {}
 
-Bird::Bird(std::string aname, double wS) : Animal(aname) { 
-    _kind = Kind::Bird;
-    wingSpan = wS;
+Bird::Bird(Kind kind, std::string aname, double wS) : Animal(kind, aname) { 
+    pool().wingSpan[row()] = wS;
 }
 
+Bird::Bird(ZooWorld& w, AnimalHandle h) : Animal(w, h) {}
+
 void Bird::Fly() { std::cout << "Whoosh. Swoosh. Whoosh... " << std::endl; }
 
 // Reptile
-Reptile::Reptile() : Animal() { 
-    _kind = Kind::Reptile;
-}
+Reptile::Reptile() : Animal(Kind::Reptile, "Unknown") {}
 
-Reptile::Reptile(std::string aname) : Animal(aname) { 
-    _kind = Kind::Reptile;
-}
+Reptile::Reptile(std::string aname) : Animal(Kind::Reptile, aname) {}
+
+Reptile::Reptile(Kind kind, std::string aname) : Animal(kind, aname) {}
+
+Reptile::Reptile(ZooWorld& w, AnimalHandle h) : Animal(w, h) {}
 
 void Reptile::Sunbathe() { std::cout << "Nice. Nice. Nice...." << std::endl; }
 
 // Lion 
-Lion::Lion() : Mammal() { 
-    _kind = Kind::Lion;
-    roarPower = 5;
-}
+Lion::Lion() : Mammal(Kind::Lion, "Unknown") {}
 
-Lion::Lion(std::string aname, int power) : Mammal(aname) {
-    _kind = Kind::Lion;
-    roarPower = power;
+Lion::Lion(std::string aname, int power) : Mammal(Kind::Lion, aname) {
+    pool().roarPower[row()] = power;
 }
 
+Lion::Lion(ZooWorld& w, AnimalHandle h) : Mammal(w, h) {}
+
 void Lion::Roar() { 
+    int roarPower = pool().roarPower[row()];
     for(int i = 0; i < roarPower; ++i) {
         std::cout << "Roar. ";
     }
     std::cout << std::endl;
 }
 
+int Lion::RoarPower() const { return pool().roarPower[row()]; }
+
 // Tiger 
-Tiger::Tiger() : Mammal() { 
-    _kind = Kind::Tiger;
-    jumpHeight = 3.5;
-}
+Tiger::Tiger() : Mammal(Kind::Tiger, "Unknown") {}
 
-Tiger::Tiger(std::string aname, double jmp) : Mammal(aname) {
-    _kind = Kind::Tiger;
-    jumpHeight = jmp;
+Tiger::Tiger(std::string aname, double jmp) : Mammal(Kind::Tiger, aname) {
+    pool().jumpHeight[row()] = jmp;
 }
 
+Tiger::Tiger(ZooWorld& w, AnimalHandle h) : Mammal(w, h) {}
+
 void Tiger::Jump() { std::cout << "Juuuuump..." << std::endl; }
 
+double Tiger::JumpHeight() const { return pool().jumpHeight[row()]; }
+
 // Elephant
-Elephant::Elephant() : Mammal() { 
-    _kind = Kind::Elephant;
-    trunkLength = 2.4;
-}
+Elephant::Elephant() : Mammal(Kind::Elephant, "Unknown") {}
 
-Elephant::Elephant(std::string aname) : Mammal(aname) { 
-    _kind = Kind::Elephant;
-    trunkLength = 2.4;
-}
+Elephant::Elephant(std::string aname) : Mammal(Kind::Elephant, aname) {}
+
+Elephant::Elephant(ZooWorld& w, AnimalHandle h) : Mammal(w, h) {}
 
 void Elephant::UseTrunk() { std::cout << "Frrrrnnnn" << std::endl; }
 
+double Elephant::TrunkLength() const { return pool().trunkLength[row()]; }
+
 // Eagle
-Eagle::Eagle() : Bird() { 
-    _kind = Kind::Eagle;
-    visionRange = 100.0;
-}
+Eagle::Eagle() : Bird(Kind::Eagle, "Unknown") {}
 
-Eagle::Eagle(std::string aname, double vision) : Bird(aname) { 
-    _kind = Kind::Eagle;
-    visionRange = vision;
+Eagle::Eagle(std::string aname, double vision) : Bird(Kind::Eagle, aname) { 
+    pool().visionRange[row()] = vision;
 }
 
+Eagle::Eagle(ZooWorld& w, AnimalHandle h) : Bird(w, h) {}
+
 void Eagle::Soar() { std::cout << "Soaring..." << std::endl; }
 
+double Eagle::VisionRange() const { return pool().visionRange[row()]; }
+
 // Parrot
-Parrot::Parrot() : Bird() { 
-    _kind = Kind::Parrot;
-    vocabulary = {"Hello", "Pretty bird"};
+Parrot::Parrot() : Bird(Kind::Parrot, "Unknown") { 
+    pool().vocabulary[row()] = {Symbols::intern("Hello"), Symbols::intern("Pretty bird")};
 }
 
-Parrot::Parrot(std::string aname, std::vector<std::string> words) : Bird(aname) { 
-    _kind = Kind::Parrot;
-    vocabulary = words;
+Parrot::Parrot(std::string aname, std::vector<std::string> words) : Bird(Kind::Parrot, aname) { 
+    std::vector<Symbol>& vocabulary = pool().vocabulary[row()];
+    for (const std::string& word : words) vocabulary.push_back(Symbols::intern(word));
 }
 
+Parrot::Parrot(ZooWorld& w, AnimalHandle h) : Bird(w, h) {}
+
 void Parrot::Speak() {
+    const std::vector<Symbol>& vocabulary = pool().vocabulary[row()];
     if (vocabulary.empty()) {
-        std::cout << name << " mmmmm..." << std::endl;
+        std::cout << Name() << " mmmmm..." << std::endl;
         return;
     }
-    std::cout << name << " says: ";
-    for (const std::string& word : vocabulary) {
+    std::cout << Name() << " says: ";
+    for (Symbol word : vocabulary) {
         std::cout << word << " ";
     }
     std::cout << std::endl;
 }
 
+const std::vector<Symbol>& Parrot::Vocabulary() const { return pool().vocabulary[row()]; }
+
 // Snake
-Snake::Snake() : Reptile() { 
-    _kind = Kind::Snake;
-    poisonous = false;
-}
+Snake::Snake() : Reptile(Kind::Snake, "Unknown") {}
 
-Snake::Snake(std::string aname, bool poison) : Reptile(aname) { 
-    _kind = Kind::Snake;
-    poisonous = poison;
+Snake::Snake(std::string aname, bool poison) : Reptile(Kind::Snake, aname) { 
+    pool().poisonous[row()] = poison;
 }
 
+Snake::Snake(ZooWorld& w, AnimalHandle h) : Reptile(w, h) {}
+
 void Snake::Hiss() {
-    if (poisonous) std::cout << "Fshhhhhh...";
+    if (pool().poisonous[row()]) std::cout << "Fshhhhhh...";
     else std::cout << "Sssssss...";
     std::cout << std::endl;
 }
 
+bool Snake::Poisonous() const { return pool().poisonous[row()] != 0; }
+
 // Crocodile
-Crocodile::Crocodile() : Reptile() { 
-    _kind = Kind::Crocodile;
-    biteForce = 5;
-}
+Crocodile::Crocodile() : Reptile(Kind::Crocodile, "Unknown") {}
 
-Crocodile::Crocodile(std::string aname, int force) : Reptile(aname) {
-    _kind = Kind::Crocodile;
-    biteForce = force;
+Crocodile::Crocodile(std::string aname, int force) : Reptile(Kind::Crocodile, aname) {
+    pool().biteForce[row()] = force;
 }
 
+Crocodile::Crocodile(ZooWorld& w, AnimalHandle h) : Reptile(w, h) {}
+
 void Crocodile::Snap() {
+    int biteForce = pool().biteForce[row()];
     for(int i = 0; i < biteForce; ++i) {
         std::cout << "SNAP! ";
     }
     std::cout << std::endl;
-}
\ No newline at end of file
+}
+
+int Crocodile::BiteForce() const { return pool().biteForce[row()]; }
+
+// Zoo
+namespace {
+
+// Hunger gained per hour, by Kind.
+const double hungerRate[kindCount] = {3, 3, 3, 3, 4, 4, 3, 5, 6, 1, 1};
+
+// A species' behaviour fires when its watched column is above (or below)
+// the limit after the update.
+struct Rule {
+    bool active;
+    bool onHunger;
+    bool above;
+    std::uint8_t limit;
+};
+
+const Rule rules[kindCount] = {
+    {false, false, false, 0},  // Animal
+    {false, false, false, 0},  // Mammal
+    {false, false, false, 0},  // Bird
+    {false, false, false, 0},  // Reptile
+    {true, true, true, 70},    // Lion roars when hungry
+    {true, false, true, 99},   // Tiger jumps at full health
+    {true, true, true, 50},    // Elephant uses its trunk
+    {true, false, true, 80},   // Eagle soars when healthy
+    {true, true, false, 20},   // Parrot speaks when fed
+    {true, false, false, 50},  // Snake hisses when weak
+    {true, true, true, 90},    // Crocodile snaps when starving
+};
+
+const std::size_t chunkRows = 16384;
+
+}
+
+Zoo::Zoo(ZooWorld& w, unsigned threads) : state(w), workers(threads) {}
+
+void Zoo::onBehaviour(Kind kind, Hook hook) { hooks[static_cast<std::size_t>(kind)] = std::move(hook); }
+
+TickStats Zoo::tick(double dt) {
+    if (!std::isfinite(dt) || dt < 0) {
+        std::cout << "Invalid tick length: " << dt << std::endl;
+        return TickStats();
+    }
+
+    // Whole hunger steps per Kind come from the shared clock, so every animal
+    // of a kind moves by the same amount and no fractions are stored per row.
+    std::uint8_t steps[kindCount];
+    for (std::size_t k = 0; k < kindCount; ++k) {
+        double s = std::floor((elapsed + dt) * hungerRate[k]) - std::floor(elapsed * hungerRate[k]);
+        steps[k] = static_cast<std::uint8_t>(std::clamp(s, 0.0, 100.0));
+    }
+    elapsed += dt;
+
+    chunks.clear();
+    for (std::size_t k = 0; k < kindCount; ++k) {
+        std::size_t n = state.pool(static_cast<Kind>(k)).size();
+        for (std::size_t b = 0; b < n; b += chunkRows)
+            chunks.push_back(Chunk{static_cast<Kind>(k), b, std::min(n, b + chunkRows), 0, 0, {}});
+    }
+
+    workers.run(chunks.size(), [&](std::size_t c) {
+        Chunk& chunk = chunks[c];
+        std::size_t k = static_cast<std::size_t>(chunk.kind);
+        SpeciesPool& p = state.pool(chunk.kind);
+        std::uint8_t* hunger = p.hunger.data();
+        std::uint8_t* health = p.health.data();
+        const Rule& rule = rules[k];
+        bool record = static_cast<bool>(hooks[k]);
+        int step = steps[k];
+
+        for (std::size_t i = chunk.begin; i < chunk.end; ++i) {
+            int h = std::min(100, hunger[i] + step);
+            int hp = health[i];
+            if (h > 80) hp = std::max(0, hp - step);
+            else if (h < 30) hp = std::min(100, hp + step);
+            hunger[i] = static_cast<std::uint8_t>(h);
+            health[i] = static_cast<std::uint8_t>(hp);
+            chunk.starving += h > 80;
+
+            if (!rule.active) continue;
+            int watched = rule.onHunger ? h : hp;
+            if (rule.above ? watched > rule.limit : watched < rule.limit) {
+                ++chunk.fired;
+                if (record) chunk.rows.push_back(static_cast<std::uint32_t>(i));
+            }
+        }
+    });
+
+    // Each kind has its own index entries, so kinds sync in parallel.
+    if (ZooIndex* index = state.attached())
+        workers.run(kindCount, [&](std::size_t k) { index->sync(static_cast<Kind>(k)); });
+
+    TickStats stats;
+    for (const Chunk& chunk : chunks) {
+        std::size_t k = static_cast<std::size_t>(chunk.kind);
+        stats.behaviours[k] += chunk.fired;
+        stats.starving += chunk.starving;
+        for (std::uint32_t row : chunk.rows) hooks[k](state.handleAt(chunk.kind, row));
+    }
+    return stats;
+}
+
+
+// Report
+namespace {
+
+const char* const kindNames[kindCount] = {
+    "Animal", "Mammal", "Bird", "Reptile",
+    "Lion", "Tiger", "Elephant", "Eagle", "Parrot", "Snake", "Crocodile"
+};
+
+Kind classOf(Kind kind) {
+    switch (kind) {
+        case Kind::Lion: case Kind::Tiger: case Kind::Elephant: return Kind::Mammal;
+        case Kind::Eagle: case Kind::Parrot: return Kind::Bird;
+        case Kind::Snake: case Kind::Crocodile: return Kind::Reptile;
+        default: return kind;
+    }
+}
+
+}
+
+void reportAnimals(ReportWriter& out, const ZooWorld& world) {
+    out.columns({"id", "name", "class", "species", "hunger", "health", "roarPower", "jumpHeight",
+                 "trunkLength", "wingSpan", "visionRange", "vocabulary", "poisonous", "biteForce"});
+    std::string words;
+    for (std::size_t k = 0; k < kindCount; ++k) {
+        const SpeciesPool& p = world.pool(static_cast<Kind>(k));
+        const char* species = kindNames[k];
+        const char* kindClass = kindNames[static_cast<std::size_t>(classOf(p.kind))];
+        for (std::size_t i = 0; i < p.size(); ++i) {
+            out.beginRecord();
+            out.field("id", p.id[i]);
+            out.field("name", Symbols::str(p.name[i]));
+            out.field("class", kindClass);
+            out.field("species", species);
+            out.field("hunger", int(p.hunger[i]));
+            out.field("health", int(p.health[i]));
+            if (p.roarPower.empty()) out.none("roarPower"); else out.field("roarPower", p.roarPower[i]);
+            if (p.jumpHeight.empty()) out.none("jumpHeight"); else out.field("jumpHeight", p.jumpHeight[i]);
+            if (p.trunkLength.empty()) out.none("trunkLength"); else out.field("trunkLength", p.trunkLength[i]);
+            if (p.wingSpan.empty()) out.none("wingSpan"); else out.field("wingSpan", p.wingSpan[i]);
+            if (p.visionRange.empty()) out.none("visionRange"); else out.field("visionRange", p.visionRange[i]);
+            if (p.vocabulary.empty()) {
+                out.none("vocabulary");
+            } else {
+                words.clear();
+                for (Symbol w : p.vocabulary[i]) {
+                    if (!words.empty()) words += ' ';
+                    words += Symbols::str(w);
+                }
+                out.field("vocabulary", words);
+            }
+            if (p.poisonous.empty()) out.none("poisonous"); else out.field("poisonous", p.poisonous[i] != 0);
+            if (p.biteForce.empty()) out.none("biteForce"); else out.field("biteForce", p.biteForce[i]);
+            out.endRecord();
+        }
+    }
+}
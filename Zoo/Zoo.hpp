@@ -2,68 +2,128 @@
 #define ZOO_HPP
 
 #include "Type.hpp"
+#include "../WorkStealingPool/WorkStealingPool.hpp"
+#include "../Report/ReportWriter.hpp"
+
+#include <array>
+#include <functional>
 
 class Lion : public Mammal {
-    int roarPower;
 public:
     Lion();
     Lion(std::string aname, int power = 5);
+    Lion(ZooWorld& w, AnimalHandle h);
     void Roar();
+    int RoarPower() const;
     void PrintInfo() const;
 };
 
 class Tiger : public Mammal {
-    double jumpHeight;
 public:
     Tiger();
     Tiger(std::string aname, double jmp = 3.5);
+    Tiger(ZooWorld& w, AnimalHandle h);
     void Jump();
+    double JumpHeight() const;
     void PrintInfo() const;
 };
 
 class Elephant : public Mammal {    
-    double trunkLength;
 public:
     Elephant();
     Elephant(std::string aname);
+    Elephant(ZooWorld& w, AnimalHandle h);
     void UseTrunk();
+    double TrunkLength() const;
     void PrintInfo() const;
 };
 
 class Eagle : public Bird {
-    double visionRange;
 public:
     Eagle();
     Eagle(std::string aname, double vision = 100.0);
+    Eagle(ZooWorld& w, AnimalHandle h);
     void Soar();
+    double VisionRange() const;
     void PrintInfo() const;
 };
 
 class Parrot : public Bird {
-    std::vector<std::string> vocabulary;
 public:
     Parrot();
     Parrot(std::string aname, std::vector<std::string> words);
+    Parrot(ZooWorld& w, AnimalHandle h);
     void Speak();
+    const std::vector<Symbol>& Vocabulary() const;
     void PrintInfo() const;
 };
 
 class Snake : public Reptile {
-    bool poisonous;
 public:
     Snake();
     Snake(std::string aname, bool poison = false);
+    Snake(ZooWorld& w, AnimalHandle h);
     void Hiss();
+    bool Poisonous() const;
     void PrintInfo() const;
 };
 
 class Crocodile : public Reptile {
-    int biteForce;
 public:
     Crocodile();
     Crocodile(std::string aname, int force = 5);
+    Crocodile(ZooWorld& w, AnimalHandle h);
     void Snap();
+    int BiteForce() const;
     void PrintInfo() const;
 };
 
-#endif
\ No newline at end of file
+// What one tick did: how often each species' behaviour fired and how many
+// animals were starving (hunger above 80) at its end.
+struct TickStats {
+    std::array<std::size_t, kindCount> behaviours{};
+    std::size_t starving = 0;
+};
+
+// Runs the simulation over a ZooWorld. Each tick advances hunger by a
+// per-species rate, moves health with hunger, and fires each species'
+// behaviour (Roar, Jump, Soar, Hiss, ...) where its rule holds. Rows are
+// updated in parallel chunks; hooks run afterwards on the calling thread in
+// pool and row order, so results do not depend on the thread count.
+class Zoo {
+public:
+    using Hook = std::function<void(AnimalHandle)>;
+
+    explicit Zoo(ZooWorld& w = ZooWorld::global(), unsigned threads = std::thread::hardware_concurrency());
+
+    // Called for every animal of `kind` whose behaviour fires in a tick.
+    // Hooks must not add or remove animals.
+    void onBehaviour(Kind kind, Hook hook);
+
+    // Advances the world by dt hours. A negative or non-finite dt is
+    // reported and leaves the world unchanged.
+    TickStats tick(double dt);
+
+    ZooWorld& world() { return state; }
+    unsigned threads() const { return workers.size(); }
+
+private:
+    struct Chunk {
+        Kind kind;
+        std::size_t begin, end;
+        std::size_t fired = 0, starving = 0;
+        std::vector<std::uint32_t> rows;
+    };
+
+    ZooWorld& state;
+    WorkStealingPool workers;
+    std::array<Hook, kindCount> hooks;
+    std::vector<Chunk> chunks;
+    double elapsed = 0.0;
+};
+
+// Writes one record per animal of the world, pool by pool, with the
+// species fields of its kind.
+void reportAnimals(ReportWriter& out, const ZooWorld& world);
+
+#endif
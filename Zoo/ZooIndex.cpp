@@ -0,0 +1,185 @@
+#include "ZooIndex.hpp"
+
+#include <algorithm>
+
+static KindSet bit(Kind kind) { return KindSet(1u << static_cast<unsigned>(kind)); }
+
+KindSet kindsOf(Kind kind) {
+    switch (kind) {
+        case Kind::Animal:  return KindSet((1u << kindCount) - 1);
+        case Kind::Mammal:  return bit(Kind::Mammal) | bit(Kind::Lion) | bit(Kind::Tiger) | bit(Kind::Elephant);
+        case Kind::Bird:    return bit(Kind::Bird) | bit(Kind::Eagle) | bit(Kind::Parrot);
+        case Kind::Reptile: return bit(Kind::Reptile) | bit(Kind::Snake) | bit(Kind::Crocodile);
+        default:            return bit(kind);
+    }
+}
+
+// Buckets
+void ZooIndex::Buckets::insert(std::uint32_t slot, std::uint8_t value) {
+    if (pos.size() <= slot) pos.resize(slot + 1);
+    pos[slot] = static_cast<std::uint32_t>(slots[value].size());
+    slots[value].push_back(slot);
+}
+
+void ZooIndex::Buckets::erase(std::uint32_t slot, std::uint8_t value) {
+    std::vector<std::uint32_t>& bucket = slots[value];
+    std::uint32_t last = bucket.back();
+    bucket[pos[slot]] = last;
+    pos[last] = pos[slot];
+    bucket.pop_back();
+}
+
+std::size_t ZooIndex::Buckets::count(Range r) const {
+    std::size_t n = 0;
+    for (int v = r.min; v <= std::min<int>(r.max, 100); ++v) n += slots[v].size();
+    return n;
+}
+
+// ZooIndex
+ZooIndex::ZooIndex(ZooWorld& w) : world(w) {
+    reindex();
+    world.attach(this);
+}
+
+ZooIndex::~ZooIndex() {
+    if (world.attached() == this) world.attach(nullptr);
+}
+
+void ZooIndex::insert(KindIndex& index, std::uint32_t slot, std::uint8_t hunger, std::uint8_t health) {
+    if (index.hunger.size() <= slot) {
+        index.hunger.resize(slot + 1);
+        index.health.resize(slot + 1);
+        index.alive.resize(slot / 64 + 1);
+    }
+    index.alive[slot / 64] |= std::uint64_t(1) << (slot % 64);
+    index.hunger[slot] = hunger;
+    index.health[slot] = health;
+    index.byHunger.insert(slot, hunger);
+    index.byHealth.insert(slot, health);
+    ++index.count;
+}
+
+void ZooIndex::added(AnimalHandle h) {
+    const SpeciesPool& p = world.pool(h.kind);
+    std::size_t r = world.row(h);
+    insert(kinds[static_cast<std::size_t>(h.kind)], h.slot, p.hunger[r], p.health[r]);
+}
+
+void ZooIndex::removed(AnimalHandle h) {
+    KindIndex& index = kinds[static_cast<std::size_t>(h.kind)];
+    index.alive[h.slot / 64] &= ~(std::uint64_t(1) << (h.slot % 64));
+    index.byHunger.erase(h.slot, index.hunger[h.slot]);
+    index.byHealth.erase(h.slot, index.health[h.slot]);
+    --index.count;
+}
+
+void ZooIndex::changed(AnimalHandle h) {
+    KindIndex& index = kinds[static_cast<std::size_t>(h.kind)];
+    const SpeciesPool& p = world.pool(h.kind);
+    std::size_t r = world.row(h);
+    if (p.hunger[r] != index.hunger[h.slot]) {
+        index.byHunger.erase(h.slot, index.hunger[h.slot]);
+        index.byHunger.insert(h.slot, p.hunger[r]);
+        index.hunger[h.slot] = p.hunger[r];
+    }
+    if (p.health[r] != index.health[h.slot]) {
+        index.byHealth.erase(h.slot, index.health[h.slot]);
+        index.byHealth.insert(h.slot, p.health[r]);
+        index.health[h.slot] = p.health[r];
+    }
+}
+
+// Moves changed entries one by one, or rebuilds the kind when more than an
+// eighth of it changed, since then refilling the buckets in row order is
+// cheaper than scattered moves.
+void ZooIndex::sync(Kind kind) {
+    KindIndex& index = kinds[static_cast<std::size_t>(kind)];
+    const SpeciesPool& p = world.pool(kind);
+    std::size_t n = p.size();
+
+    std::size_t differ = 0;
+    for (std::size_t r = 0; r < n; ++r) {
+        std::uint32_t slot = p.slots[r];
+        differ += (p.hunger[r] != index.hunger[slot]) | (p.health[r] != index.health[slot]);
+    }
+    if (differ == 0) return;
+    if (differ > n / 8) {
+        rebuild(kind);
+        return;
+    }
+    for (std::size_t r = 0; r < n; ++r) {
+        std::uint32_t slot = p.slots[r];
+        if (p.hunger[r] != index.hunger[slot] || p.health[r] != index.health[slot])
+            changed(AnimalHandle{kind, slot, p.generations[slot]});
+    }
+}
+
+void ZooIndex::reindex() {
+    for (std::size_t k = 0; k < kindCount; ++k) rebuild(static_cast<Kind>(k));
+}
+
+void ZooIndex::rebuild(Kind kind) {
+    KindIndex& index = kinds[static_cast<std::size_t>(kind)];
+    const SpeciesPool& p = world.pool(kind);
+    std::size_t slots = p.rows.size();
+
+    index.count = 0;
+    index.alive.assign((slots + 63) / 64, 0);
+    index.hunger.assign(slots, 0);
+    index.health.assign(slots, 0);
+    for (std::vector<std::uint32_t>& bucket : index.byHunger.slots) bucket.clear();
+    for (std::vector<std::uint32_t>& bucket : index.byHealth.slots) bucket.clear();
+    index.byHunger.pos.resize(slots);
+    index.byHealth.pos.resize(slots);
+
+    for (std::size_t r = 0; r < p.size(); ++r) insert(index, p.slots[r], p.hunger[r], p.health[r]);
+}
+
+std::size_t ZooIndex::count(KindSet set) const {
+    std::size_t n = 0;
+    for (std::size_t k = 0; k < kindCount; ++k)
+        if (set & (1u << k)) n += kinds[k].count;
+    return n;
+}
+
+std::vector<std::uint64_t> ZooIndex::ids(KindSet set) const {
+    std::vector<std::uint64_t> out;
+    out.reserve(count(set));
+    for (std::size_t k = 0; k < kindCount; ++k) {
+        if (!(set & (1u << k))) continue;
+        const KindIndex& index = kinds[k];
+        const SpeciesPool& p = world.pool(static_cast<Kind>(k));
+        for (std::size_t w = 0; w < index.alive.size(); ++w) {
+            for (std::uint64_t bits = index.alive[w]; bits; bits &= bits - 1) {
+                std::size_t slot = w * 64 + __builtin_ctzll(bits);
+                out.push_back(p.id[p.rows[slot]]);
+            }
+        }
+    }
+    return out;
+}
+
+// Walks the buckets of whichever attribute matches fewer animals and checks
+// the other attribute from the cached values.
+std::vector<std::uint64_t> ZooIndex::query(KindSet set, Range hunger, Range health) const {
+    std::vector<std::uint64_t> out;
+    for (std::size_t k = 0; k < kindCount; ++k) {
+        if (!(set & (1u << k))) continue;
+        const KindIndex& index = kinds[k];
+        const SpeciesPool& p = world.pool(static_cast<Kind>(k));
+
+        bool byHunger = index.byHunger.count(hunger) <= index.byHealth.count(health);
+        const Buckets& buckets = byHunger ? index.byHunger : index.byHealth;
+        Range walk = byHunger ? hunger : health;
+        Range check = byHunger ? health : hunger;
+        const std::vector<std::uint8_t>& other = byHunger ? index.health : index.hunger;
+
+        for (int v = walk.min; v <= std::min<int>(walk.max, 100); ++v) {
+            for (std::uint32_t slot : buckets.slots[v]) {
+                std::uint8_t x = other[slot];
+                if (x >= check.min && x <= check.max) out.push_back(p.id[p.rows[slot]]);
+            }
+        }
+    }
+    return out;
+}
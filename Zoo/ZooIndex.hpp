@@ -0,0 +1,82 @@
+#ifndef ZOOINDEX_HPP
+#define ZOOINDEX_HPP
+
+#include "ZooWorld.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// A set of Kinds, one bit per Kind value.
+using KindSet = std::uint16_t;
+
+// The kind and every kind below it, e.g. Reptile -> Reptile, Snake, Crocodile.
+KindSet kindsOf(Kind kind);
+
+// Inclusive range of hunger or health values.
+struct Range {
+    std::uint8_t min = 0;
+    std::uint8_t max = 100;
+};
+
+// Secondary index over a ZooWorld. Each Kind keeps a bitset of live handle
+// slots and buckets of slots for every hunger and health value, so a query
+// only visits matching animals. The world keeps it current: add, remove and
+// feed update single entries, and bulk updates and ticks call sync.
+class ZooIndex {
+public:
+    // Indexes every animal already in the world and attaches to it.
+    explicit ZooIndex(ZooWorld& w);
+    ~ZooIndex();
+
+    ZooIndex(const ZooIndex&) = delete;
+    ZooIndex& operator=(const ZooIndex&) = delete;
+
+    std::size_t count(KindSet kinds) const;
+
+    // Ids of the animals of the given kinds, in kind then slot order.
+    std::vector<std::uint64_t> ids(KindSet kinds) const;
+
+    // Ids of the animals of the given kinds with hunger and health in range.
+    std::vector<std::uint64_t> query(KindSet kinds, Range hunger, Range health = Range()) const;
+
+    void added(AnimalHandle h);
+    void removed(AnimalHandle h);
+    void changed(AnimalHandle h);
+
+    // Re-reads hunger and health of every animal of a kind and moves the
+    // entries that changed. Needed after writing the columns directly.
+    void sync(Kind kind);
+
+    // Rebuilds every kind, after the world's animals were replaced wholesale.
+    void reindex();
+
+private:
+    // Slots grouped by value, with each slot's position in its bucket so it
+    // can be moved in O(1).
+    struct Buckets {
+        std::array<std::vector<std::uint32_t>, 101> slots;
+        std::vector<std::uint32_t> pos;
+
+        void insert(std::uint32_t slot, std::uint8_t value);
+        void erase(std::uint32_t slot, std::uint8_t value);
+        std::size_t count(Range r) const;
+    };
+
+    struct KindIndex {
+        std::vector<std::uint64_t> alive;
+        std::vector<std::uint8_t> hunger;
+        std::vector<std::uint8_t> health;
+        Buckets byHunger;
+        Buckets byHealth;
+        std::size_t count = 0;
+    };
+
+    void insert(KindIndex& index, std::uint32_t slot, std::uint8_t hunger, std::uint8_t health);
+    void rebuild(Kind kind);
+
+    ZooWorld& world;
+    std::array<KindIndex, kindCount> kinds;
+};
+
+#endif
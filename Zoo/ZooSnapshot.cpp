@@ -0,0 +1,292 @@
+#include "ZooSnapshot.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const std::size_t columnCount = static_cast<std::size_t>(Column::Count);
+
+const std::size_t columnWidth[columnCount] = {8, 1, 1, 4, 4, 8, 8, 8, 8, 4, 1, 4};
+
+bool littleEndian() {
+    std::uint16_t one = 1;
+    unsigned char first;
+    std::memcpy(&first, &one, 1);
+    return first == 1;
+}
+
+bool hasColumn(Kind kind, Column c) {
+    switch (c) {
+        case Column::Id: case Column::Hunger: case Column::Health: case Column::Name:
+            return true;
+        case Column::RoarPower:   return kind == Kind::Lion;
+        case Column::JumpHeight:  return kind == Kind::Tiger;
+        case Column::TrunkLength: return kind == Kind::Elephant;
+        case Column::WingSpan:    return kind == Kind::Bird || kind == Kind::Eagle || kind == Kind::Parrot;
+        case Column::VisionRange: return kind == Kind::Eagle;
+        case Column::Vocabulary:  return kind == Kind::Parrot;
+        case Column::Poisonous:   return kind == Kind::Snake;
+        case Column::BiteForce:   return kind == Kind::Crocodile;
+        default:                  return false;
+    }
+}
+
+// Sequential binary writer that tracks its position for offsets.
+class Writer {
+    std::ofstream out;
+    std::uint64_t pos = 0;
+public:
+    explicit Writer(const std::string& path) : out(path, std::ios::binary | std::ios::trunc) {}
+
+    bool ok() const { return static_cast<bool>(out); }
+    std::uint64_t tell() const { return pos; }
+
+    void bytes(const void* p, std::size_t n) {
+        out.write(static_cast<const char*>(p), n);
+        pos += n;
+    }
+
+    void align() {
+        static const char zeros[8] = {};
+        bytes(zeros, (8 - pos % 8) % 8);
+    }
+
+    template <typename T>
+    std::uint64_t array(const T* p, std::size_t n) {
+        align();
+        std::uint64_t at = pos;
+        bytes(p, n * sizeof(T));
+        return at;
+    }
+
+    void rewrite(std::uint64_t at, const void* p, std::size_t n) {
+        out.seekp(at);
+        out.write(static_cast<const char*>(p), n);
+        out.seekp(pos);
+    }
+};
+
+// Copies the symbols a snapshot uses into its own string table, so the
+// file does not depend on the process's symbol numbering.
+class StringTable {
+    std::vector<std::uint32_t> index;  // symbol -> string index + 1, 0 if absent
+public:
+    std::vector<std::uint64_t> offsets{0};
+    std::string bytes;
+
+    std::uint32_t intern(Symbol s) {
+        if (index.size() <= s.id) index.resize(s.id + 1);
+        if (index[s.id]) return index[s.id] - 1;
+        std::uint32_t id = static_cast<std::uint32_t>(offsets.size() - 1);
+        index[s.id] = id + 1;
+        bytes += Symbols::str(s);
+        offsets.push_back(bytes.size());
+        return id;
+    }
+};
+
+}
+
+bool saveSnapshot(const ZooWorld& world, const std::string& path) {
+    if (!littleEndian()) {
+        std::cout << "Snapshots need a little-endian host!" << std::endl;
+        return false;
+    }
+    Writer out(path);
+    if (!out.ok()) {
+        std::cout << "Cannot write " << path << std::endl;
+        return false;
+    }
+
+    snapshot::Header header{};
+    std::memcpy(header.magic, snapshot::magic, 4);
+    header.version = snapshot::version;
+    header.kinds = kindCount;
+    header.columns = columnCount;
+    snapshot::KindEntry entries[kindCount] = {};
+
+    out.bytes(&header, sizeof(header));
+    out.bytes(entries, sizeof(entries));
+
+    StringTable strings;
+    std::vector<std::uint32_t> words;
+    std::vector<std::uint32_t> names;
+    std::vector<std::uint32_t> starts;
+
+    for (std::size_t k = 0; k < kindCount; ++k) {
+        Kind kind = static_cast<Kind>(k);
+        const SpeciesPool& p = world.pool(kind);
+        std::size_t n = p.size();
+        snapshot::KindEntry& e = entries[k];
+        e.rows = n;
+
+        auto put = [&](Column c, auto& column) {
+            if (hasColumn(kind, c)) e.offsets[static_cast<std::size_t>(c)] = out.array(column.data(), n);
+        };
+        put(Column::Id, p.id);
+        put(Column::Hunger, p.hunger);
+        put(Column::Health, p.health);
+
+        names.resize(n);
+        for (std::size_t i = 0; i < n; ++i) names[i] = strings.intern(p.name[i]);
+        put(Column::Name, names);
+
+        put(Column::RoarPower, p.roarPower);
+        put(Column::JumpHeight, p.jumpHeight);
+        put(Column::TrunkLength, p.trunkLength);
+        put(Column::WingSpan, p.wingSpan);
+        put(Column::VisionRange, p.visionRange);
+        put(Column::Poisonous, p.poisonous);
+        put(Column::BiteForce, p.biteForce);
+
+        if (hasColumn(kind, Column::Vocabulary)) {
+            starts.assign(1, static_cast<std::uint32_t>(words.size()));
+            for (const std::vector<Symbol>& vocabulary : p.vocabulary) {
+                for (Symbol w : vocabulary) words.push_back(strings.intern(w));
+                starts.push_back(static_cast<std::uint32_t>(words.size()));
+            }
+            e.offsets[static_cast<std::size_t>(Column::Vocabulary)] = out.array(starts.data(), starts.size());
+        }
+    }
+
+    header.wordCount = words.size();
+    header.words = out.array(words.data(), words.size());
+
+    out.align();
+    header.strings = out.tell();
+    std::uint64_t stringCount = strings.offsets.size() - 1;
+    out.bytes(&stringCount, sizeof(stringCount));
+    out.bytes(strings.offsets.data(), strings.offsets.size() * sizeof(std::uint64_t));
+    out.bytes(strings.bytes.data(), strings.bytes.size());
+
+    out.rewrite(0, &header, sizeof(header));
+    out.rewrite(sizeof(header), entries, sizeof(entries));
+    if (!out.ok()) {
+        std::cout << "Error writing " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// ZooSnapshot
+ZooSnapshot::~ZooSnapshot() { close(); }
+
+void ZooSnapshot::close() {
+    if (data) munmap(const_cast<char*>(data), length);
+    data = nullptr;
+    length = 0;
+    stringCount = 0;
+    wordCount = 0;
+}
+
+bool ZooSnapshot::open(const std::string& path) {
+    close();
+    if (!littleEndian()) {
+        std::cout << "Snapshots need a little-endian host!" << std::endl;
+        return false;
+    }
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cout << "Cannot open " << path << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        std::cout << "Cannot read " << path << std::endl;
+        ::close(fd);
+        return false;
+    }
+    void* map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        std::cout << "Cannot map " << path << std::endl;
+        return false;
+    }
+    data = static_cast<const char*>(map);
+    length = static_cast<std::size_t>(st.st_size);
+
+    auto fits = [&](std::uint64_t offset, std::uint64_t bytes) {
+        return offset <= length && bytes <= length - offset;
+    };
+    auto fail = [&](const char* why) {
+        std::cout << path << ": " << why << std::endl;
+        close();
+        return false;
+    };
+
+    const std::size_t tables = sizeof(snapshot::Header) + kindCount * sizeof(snapshot::KindEntry);
+    if (length < tables) return fail("too short for a snapshot");
+    const snapshot::Header& header = *reinterpret_cast<const snapshot::Header*>(data);
+    if (std::memcmp(header.magic, snapshot::magic, 4) != 0) return fail("not a Zoo snapshot");
+    if (header.version != snapshot::version) return fail("unsupported snapshot version");
+    if (header.kinds != kindCount || header.columns != columnCount) return fail("unexpected table layout");
+
+    for (std::size_t k = 0; k < kindCount; ++k) {
+        const snapshot::KindEntry& e = entry(static_cast<Kind>(k));
+        for (std::size_t c = 0; c < columnCount; ++c) {
+            std::uint64_t offset = e.offsets[c];
+            if (!offset) continue;
+            std::uint64_t rows = e.rows + (c == static_cast<std::size_t>(Column::Vocabulary));
+            if (offset % 8 || rows > length || !fits(offset, rows * columnWidth[c])) return fail("column out of range");
+        }
+    }
+
+    if (header.wordCount > length || !fits(header.words, header.wordCount * 4)) return fail("word list out of range");
+    words = reinterpret_cast<const std::uint32_t*>(data + header.words);
+    wordCount = header.wordCount;
+
+    // Vocabulary starts must climb through the word list, or sizes underflow.
+    for (std::size_t k = 0; k < kindCount; ++k) {
+        const std::uint32_t* starts = column<std::uint32_t>(static_cast<Kind>(k), Column::Vocabulary);
+        if (!starts) continue;
+        std::uint64_t rows = entry(static_cast<Kind>(k)).rows;
+        for (std::uint64_t r = 0; r < rows; ++r)
+            if (starts[r] > starts[r + 1]) return fail("vocabulary starts out of order");
+        if (starts[rows] > wordCount) return fail("vocabulary out of range");
+    }
+
+    if (header.strings % 8 || !fits(header.strings, 8)) return fail("string table out of range");
+    stringCount = *reinterpret_cast<const std::uint64_t*>(data + header.strings);
+    if (stringCount >= length / 8 || !fits(header.strings + 8, (stringCount + 1) * 8)) return fail("string table out of range");
+    stringOffsets = reinterpret_cast<const std::uint64_t*>(data + header.strings + 8);
+    stringBytes = data + header.strings + 8 + (stringCount + 1) * 8;
+    if (!fits(stringBytes - data, stringOffsets[stringCount])) return fail("string bytes out of range");
+    return true;
+}
+
+const snapshot::KindEntry& ZooSnapshot::entry(Kind kind) const {
+    return reinterpret_cast<const snapshot::KindEntry*>(data + sizeof(snapshot::Header))[static_cast<std::size_t>(kind)];
+}
+
+std::size_t ZooSnapshot::size(Kind kind) const { return data ? entry(kind).rows : 0; }
+
+std::string_view ZooSnapshot::string(std::uint32_t index) const {
+    if (index >= stringCount) return std::string_view();
+    std::uint64_t begin = stringOffsets[index], end = stringOffsets[index + 1];
+    if (begin > end || end > stringOffsets[stringCount]) return std::string_view();
+    return std::string_view(stringBytes + begin, end - begin);
+}
+
+std::string_view ZooSnapshot::name(Kind kind, std::size_t row) const {
+    const std::uint32_t* names = column<std::uint32_t>(kind, Column::Name);
+    return names && row < size(kind) ? string(names[row]) : std::string_view();
+}
+
+std::size_t ZooSnapshot::vocabularySize(std::size_t row) const {
+    const std::uint32_t* starts = column<std::uint32_t>(Kind::Parrot, Column::Vocabulary);
+    return starts && row < size(Kind::Parrot) ? starts[row + 1] - starts[row] : 0;
+}
+
+std::string_view ZooSnapshot::word(std::size_t row, std::size_t i) const {
+    if (i >= vocabularySize(row)) return std::string_view();
+    const std::uint32_t* starts = column<std::uint32_t>(Kind::Parrot, Column::Vocabulary);
+    return string(words[starts[row] + i]);
+}
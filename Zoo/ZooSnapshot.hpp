@@ -0,0 +1,109 @@
+#ifndef ZOOSNAPSHOT_HPP
+#define ZOOSNAPSHOT_HPP
+
+#include "ZooWorld.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Columns of a snapshot, one array per Kind each. Absent columns (species
+// fields of other kinds) have offset 0.
+enum class Column : std::uint32_t {
+    Id,           // u64
+    Hunger,       // u8
+    Health,       // u8
+    Name,         // u32 index into the string table
+    RoarPower,    // i32
+    JumpHeight,   // f64
+    TrunkLength,  // f64
+    WingSpan,     // f64
+    VisionRange,  // f64
+    Vocabulary,   // u32, count + 1 starts into the word list
+    Poisonous,    // u8
+    BiteForce,    // i32
+    Count
+};
+
+// File layout, all little-endian, every array 8-byte aligned:
+//   header   "ZOOS", version, kind and column counts, string table and
+//            word list offsets
+//   kinds    per Kind: row count, then one offset per Column
+//   columns  the arrays
+//   words    u32 string indexes of all Parrot vocabularies
+//   strings  u64 count, u64 offsets[count + 1], then the bytes
+namespace snapshot {
+    constexpr char magic[4] = {'Z', 'O', 'O', 'S'};
+    constexpr std::uint32_t version = 1;
+
+    struct Header {
+        char magic[4];
+        std::uint32_t version;
+        std::uint32_t kinds;
+        std::uint32_t columns;
+        std::uint64_t words;
+        std::uint64_t wordCount;
+        std::uint64_t strings;
+    };
+
+    struct KindEntry {
+        std::uint64_t rows;
+        std::uint64_t offsets[static_cast<std::size_t>(Column::Count)];
+    };
+}
+
+// Writes every animal of the world to path. Returns false on I/O errors.
+bool saveSnapshot(const ZooWorld& world, const std::string& path);
+
+// A snapshot mapped read-only into memory. Columns are read in place;
+// nothing is copied on open.
+class ZooSnapshot {
+public:
+    ZooSnapshot() = default;
+    ~ZooSnapshot();
+
+    ZooSnapshot(const ZooSnapshot&) = delete;
+    ZooSnapshot& operator=(const ZooSnapshot&) = delete;
+
+    // Maps and validates the file; prints the reason and returns false if it
+    // is not a readable snapshot.
+    bool open(const std::string& path);
+    void close();
+
+    std::size_t size(Kind kind) const;
+    std::size_t fileSize() const { return length; }
+
+    // Column arrays of a kind, or nullptr when the kind has no such column
+    // or no snapshot is open.
+    template <typename T>
+    const T* column(Kind kind, Column c) const {
+        if (!data) return nullptr;
+        std::uint64_t offset = entry(kind).offsets[static_cast<std::size_t>(c)];
+        return offset ? reinterpret_cast<const T*>(data + offset) : nullptr;
+    }
+
+    const std::uint64_t* ids(Kind kind) const { return column<std::uint64_t>(kind, Column::Id); }
+    const std::uint8_t* hunger(Kind kind) const { return column<std::uint8_t>(kind, Column::Hunger); }
+    const std::uint8_t* health(Kind kind) const { return column<std::uint8_t>(kind, Column::Health); }
+
+    std::string_view string(std::uint32_t index) const;
+    std::string_view name(Kind kind, std::size_t row) const;
+
+    // Number of words of a Parrot, and one of them; 0 and "" out of range.
+    std::size_t vocabularySize(std::size_t row) const;
+    std::string_view word(std::size_t row, std::size_t i) const;
+
+private:
+    const snapshot::KindEntry& entry(Kind kind) const;
+
+    const char* data = nullptr;
+    std::size_t length = 0;
+    std::uint64_t stringCount = 0;
+    const std::uint64_t* stringOffsets = nullptr;
+    const char* stringBytes = nullptr;
+    const std::uint32_t* words = nullptr;
+    std::uint64_t wordCount = 0;
+};
+
+#endif
@@ -0,0 +1,195 @@
+#include "ZooWorld.hpp"
+#include "Animal.hpp"
+#include "ZooIndex.hpp"
+#include "../IdAllocator/IdAllocator.hpp"
+
+#include <utility>
+
+ZooWorld::ZooWorld() {
+    for (std::size_t k = 0; k < kindCount; ++k) pools[k].kind = static_cast<Kind>(k);
+}
+
+// The moved-from pools are left empty, so its index rebuilds without
+// allocating.
+ZooWorld::ZooWorld(ZooWorld&& other) noexcept : pools(std::move(other.pools)) {
+    if (other.attachedIndex) other.attachedIndex->reindex();
+}
+
+ZooWorld& ZooWorld::operator=(const ZooWorld& other) {
+    if (this == &other) return *this;
+    pools = other.pools;
+    if (attachedIndex) attachedIndex->reindex();
+    return *this;
+}
+
+ZooWorld& ZooWorld::operator=(ZooWorld&& other) {
+    if (this == &other) return *this;
+    pools = std::move(other.pools);
+    if (attachedIndex) attachedIndex->reindex();
+    if (other.attachedIndex) other.attachedIndex->reindex();
+    return *this;
+}
+
+ZooWorld& ZooWorld::global() {
+    static ZooWorld world;
+    return world;
+}
+
+AnimalHandle ZooWorld::add(Kind kind, Symbol name) {
+    SpeciesPool& p = pool(kind);
+    std::uint32_t row = static_cast<std::uint32_t>(p.size());
+
+    std::uint32_t slot;
+    if (!p.freeSlots.empty()) {
+        slot = p.freeSlots.back();
+        p.freeSlots.pop_back();
+    } else {
+        slot = static_cast<std::uint32_t>(p.rows.size());
+        p.rows.push_back(0);
+        p.generations.push_back(0);
+    }
+    p.rows[slot] = row;
+    p.slots.push_back(slot);
+
+    p.id.push_back(IdAllocator::next());
+    p.name.push_back(name);
+    p.hunger.push_back(0);
+    p.health.push_back(100);
+
+    switch (kind) {
+        case Kind::Lion:      p.roarPower.push_back(5); break;
+        case Kind::Tiger:     p.jumpHeight.push_back(3.5); break;
+        case Kind::Elephant:  p.trunkLength.push_back(2.4); break;
+        case Kind::Bird:      p.wingSpan.push_back(75.4); break;
+        case Kind::Eagle:     p.wingSpan.push_back(75.4); p.visionRange.push_back(100.0); break;
+        case Kind::Parrot:    p.wingSpan.push_back(75.4); p.vocabulary.emplace_back(); break;
+        case Kind::Snake:     p.poisonous.push_back(0); break;
+        case Kind::Crocodile: p.biteForce.push_back(5); break;
+        default: break;
+    }
+    AnimalHandle h{kind, slot, p.generations[slot]};
+    if (attachedIndex) attachedIndex->added(h);
+    return h;
+}
+
+bool ZooWorld::alive(AnimalHandle h) const {
+    const SpeciesPool& p = pool(h.kind);
+    return h.slot < p.generations.size() && p.generations[h.slot] == h.generation;
+}
+
+// The last row moves into the removed one, so columns stay dense.
+bool ZooWorld::remove(AnimalHandle h) {
+    if (!alive(h)) {
+        std::cout << "Animal is already gone!" << std::endl;
+        return false;
+    }
+    if (attachedIndex) attachedIndex->removed(h);
+    SpeciesPool& p = pool(h.kind);
+    std::size_t row = p.rows[h.slot];
+    std::size_t last = p.size() - 1;
+    std::size_t count = p.size();
+
+    p.eachColumn([&](auto& column) {
+        if (column.size() != count) return;
+        if (row != last) column[row] = std::move(column[last]);
+        column.pop_back();
+    });
+    if (row != last) p.rows[p.slots[row]] = static_cast<std::uint32_t>(row);
+
+    ++p.generations[h.slot];
+    p.freeSlots.push_back(h.slot);
+    return true;
+}
+
+std::size_t ZooWorld::size() const {
+    std::size_t total = 0;
+    for (const SpeciesPool& p : pools) total += p.size();
+    return total;
+}
+
+void ZooWorld::reserve(Kind kind, std::size_t n) {
+    SpeciesPool& p = pool(kind);
+    p.rows.reserve(n);
+    p.generations.reserve(n);
+    p.slots.reserve(n);
+    p.id.reserve(n);
+    p.name.reserve(n);
+    p.hunger.reserve(n);
+    p.health.reserve(n);
+
+    switch (kind) {
+        case Kind::Lion:      p.roarPower.reserve(n); break;
+        case Kind::Tiger:     p.jumpHeight.reserve(n); break;
+        case Kind::Elephant:  p.trunkLength.reserve(n); break;
+        case Kind::Bird:      p.wingSpan.reserve(n); break;
+        case Kind::Eagle:     p.wingSpan.reserve(n); p.visionRange.reserve(n); break;
+        case Kind::Parrot:    p.wingSpan.reserve(n); p.vocabulary.reserve(n); break;
+        case Kind::Snake:     p.poisonous.reserve(n); break;
+        case Kind::Crocodile: p.biteForce.reserve(n); break;
+        default: break;
+    }
+}
+
+bool ZooWorld::feed(AnimalHandle h) {
+    SpeciesPool& p = pool(h.kind);
+    std::size_t r = row(h);
+    if (p.hunger[r] == 0 || p.health[r] == 100) return false;
+    p.hunger[r] = 0;
+    p.health[r] = 100;
+    if (attachedIndex) attachedIndex->changed(h);
+    return true;
+}
+
+// The column kernels are branch-free and run in fixed 64-row blocks, which
+// GCC vectorizes at -O2 where an open-ended loop would stay scalar.
+constexpr std::size_t block = 64;
+
+static void updateRows(std::uint8_t* __restrict hunger, std::uint8_t* __restrict health,
+                       std::size_t n, std::uint8_t starving) {
+    for (std::size_t i = 0; i < n; ++i) {
+        std::uint8_t h = hunger[i] + (hunger[i] < 100);
+        hunger[i] = h;
+        health[i] -= (h > starving) & (health[i] > 0);
+    }
+}
+
+static void updateColumns(std::uint8_t* hunger, std::uint8_t* health, std::size_t n, std::uint8_t starving) {
+    std::size_t i = 0;
+    for (; i + block <= n; i += block) updateRows(hunger + i, health + i, block, starving);
+    updateRows(hunger + i, health + i, n - i, starving);
+}
+
+static unsigned feedRows(std::uint8_t* __restrict hunger, std::uint8_t* __restrict health,
+                         std::size_t n, std::uint8_t threshold) {
+    std::uint8_t fed = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        std::uint8_t keep = -std::uint8_t(hunger[i] < threshold);
+        hunger[i] &= keep;
+        health[i] = (health[i] & keep) | (100 & ~keep);
+        fed += keep == 0;
+    }
+    return fed;
+}
+
+static std::size_t feedColumns(std::uint8_t* hunger, std::uint8_t* health, std::size_t n, std::uint8_t threshold) {
+    std::size_t fed = 0, i = 0;
+    for (; i + block <= n; i += block) fed += feedRows(hunger + i, health + i, block, threshold);
+    return fed + feedRows(hunger + i, health + i, n - i, threshold);
+}
+
+void ZooWorld::update(std::uint8_t starving) {
+    for (SpeciesPool& p : pools) updateColumns(p.hunger.data(), p.health.data(), p.size(), starving);
+    syncIndex();
+}
+
+std::size_t ZooWorld::feedHungry(std::uint8_t threshold) {
+    std::size_t fed = 0;
+    for (SpeciesPool& p : pools) fed += feedColumns(p.hunger.data(), p.health.data(), p.size(), threshold);
+    syncIndex();
+    return fed;
+}
+
+void ZooWorld::syncIndex() {
+    if (!attachedIndex) return;
+    for (std::size_t k = 0; k < kindCount; ++k) attachedIndex->sync(static_cast<Kind>(k));
+}
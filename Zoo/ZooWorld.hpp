@@ -0,0 +1,127 @@
+#ifndef ZOOWORLD_HPP
+#define ZOOWORLD_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "Symbols.hpp"
+
+enum class Kind {
+    Animal, Mammal, Bird, Reptile,
+    Lion, Tiger, Elephant,
+    Eagle, Parrot,
+    Snake, Crocodile
+};
+
+constexpr std::size_t kindCount = 11;
+
+class ZooIndex;
+
+// Refers to one animal in a ZooWorld. Stays valid while the animal lives,
+// however many other animals are added or removed.
+struct AnimalHandle {
+    Kind kind = Kind::Animal;
+    std::uint32_t slot = 0;
+    std::uint32_t generation = 0;
+};
+
+// All animals of one Kind as parallel columns, one row per animal.
+// Species columns are only filled for the kinds that have the field.
+struct SpeciesPool {
+    Kind kind = Kind::Animal;
+
+    std::vector<std::uint64_t> id;
+    std::vector<Symbol> name;
+    std::vector<std::uint8_t> hunger;   // 0..100
+    std::vector<std::uint8_t> health;   // 0..100
+
+    std::vector<int> roarPower;                       // Lion
+    std::vector<double> jumpHeight;                   // Tiger
+    std::vector<double> trunkLength;                  // Elephant
+    std::vector<double> wingSpan;                     // Bird, Eagle, Parrot
+    std::vector<double> visionRange;                  // Eagle
+    std::vector<std::vector<Symbol>> vocabulary;      // Parrot
+    std::vector<std::uint8_t> poisonous;              // Snake
+    std::vector<int> biteForce;                       // Crocodile
+
+    // slot -> row for handles, row -> slot for moving rows on removal.
+    std::vector<std::uint32_t> rows;
+    std::vector<std::uint32_t> slots;
+    std::vector<std::uint32_t> generations;
+    std::vector<std::uint32_t> freeSlots;
+
+    std::size_t size() const { return id.size(); }
+
+    // Calls f on every per-row column.
+    template <typename F>
+    void eachColumn(F f) {
+        f(id); f(name); f(hunger); f(health);
+        f(roarPower); f(jumpHeight); f(trunkLength); f(wingSpan);
+        f(visionRange); f(vocabulary); f(poisonous); f(biteForce);
+        f(slots);
+    }
+};
+
+// Owns every animal's state, pooled per Kind. The Animal classes are views
+// holding a handle into a world; bulk updates run straight over the columns.
+class ZooWorld {
+public:
+    ZooWorld();
+
+    // Copies and moves carry the animals, not the attached index. An index
+    // attached to a world whose animals are replaced, or moved away, is
+    // rebuilt to match.
+    ZooWorld(const ZooWorld& other) : pools(other.pools) {}
+    ZooWorld(ZooWorld&& other) noexcept;
+    ZooWorld& operator=(const ZooWorld& other);
+    ZooWorld& operator=(ZooWorld&& other);
+
+    // The world the Animal constructors add to.
+    static ZooWorld& global();
+
+    AnimalHandle add(Kind kind, Symbol name);
+    AnimalHandle add(Kind kind, std::string_view name) { return add(kind, Symbols::intern(name)); }
+    bool remove(AnimalHandle h);
+    bool alive(AnimalHandle h) const;
+
+    // Current dense row of a live handle.
+    std::size_t row(AnimalHandle h) const { return pool(h.kind).rows[h.slot]; }
+
+    // Handle of the animal currently in a row.
+    AnimalHandle handleAt(Kind kind, std::size_t row) const {
+        const SpeciesPool& p = pool(kind);
+        std::uint32_t slot = p.slots[row];
+        return AnimalHandle{kind, slot, p.generations[slot]};
+    }
+
+    SpeciesPool& pool(Kind kind) { return pools[static_cast<std::size_t>(kind)]; }
+    const SpeciesPool& pool(Kind kind) const { return pools[static_cast<std::size_t>(kind)]; }
+
+    std::size_t size() const;
+    void reserve(Kind kind, std::size_t n);
+
+    // Feeds one animal; false if it was not hungry (same rule as Animal::Feed).
+    bool feed(AnimalHandle h);
+
+    // One step for every animal: hunger grows by one, and animals hungrier
+    // than `starving` lose one health.
+    void update(std::uint8_t starving = 80);
+
+    // Feeds every animal with hunger >= threshold; returns how many.
+    std::size_t feedHungry(std::uint8_t threshold);
+
+    // The index kept current by add, remove, feed and the bulk updates.
+    void attach(ZooIndex* index) { attachedIndex = index; }
+    ZooIndex* attached() const { return attachedIndex; }
+
+private:
+    void syncIndex();
+
+    std::array<SpeciesPool, kindCount> pools;
+    ZooIndex* attachedIndex = nullptr;
+};
+
+#endif
@@ -0,0 +1,800 @@
+// bench.cpp
+// Benchmarks for the Zoo (C++17)
+// - Tick: one update plus feeding of the hungry over n animals (default
+//   10^7), the old heap objects behind a vector<Animal*> against the
+//   ZooWorld per-species columns.
+// - Zoo::tick: ticks/s from 1 to N threads (default: hardware threads, at
+//   least 4) over n/10 animals, checking the final state is identical.
+// - ZooIndex: query latency against a scan of the old objects with
+//   KindOf() and the getters, at n/10 and n animals, and the cost of
+//   keeping the index current through a tick. (10^8 animals need about
+//   8 GB here, so the default top size is 10^7.) Query results are checked
+//   against a full scan after feeds, removes, adds, ticks and feedHungry.
+// - Snapshot: save and mmap load of n animals, file size, and a first pass
+//   over the mapped hunger columns. A small world with every kind is read
+//   back column by column, and truncated or mislabeled files are rejected.
+// - Report: n/10 animals to a file, the old PrintInfo with std::endl per
+//   field against ReportWriter as text, CSV and JSON Lines.
+// - Dispatch: a per-species trait over n/10 animals in mixed order, via
+//   virtual calls and a switch on Kind over the old objects, std::visit
+//   over a vector<AnimalRef>, and AnimalRefs' per-species loops.
+// - Symbols: memory of names and Parrot vocabularies for n/10 animals as
+//   strings against interned symbols, interning new and known strings from
+//   1 and N threads, and finding animals by name. Symbols interned from
+//   several threads, some racing on the same strings, are checked to be
+//   equal and to round-trip through str.
+// Build:
+//   g++ -std=c++17 -O2 -pthread bench.cpp Zoo.cpp ZooWorld.cpp ZooIndex.cpp ZooSnapshot.cpp ../WorkStealingPool/WorkStealingPool.cpp Symbols.cpp ../Report/ReportWriter.cpp -o bench
+// Run:
+//   ./bench [animals] [max threads]
+// Exits with 1 if any check fails.
+
+#include "Zoo.hpp"
+#include "ZooIndex.hpp"
+#include "ZooSnapshot.hpp"
+#include "AnimalRef.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsed_ms(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Correctness checks made along the way; any failure makes main return 1.
+static int failures = 0;
+
+static void check(bool ok, const std::string& what) {
+    if (ok) return;
+    ++failures;
+    std::cout << "  FAIL " << what << std::endl;
+}
+
+static const Kind species[] = {
+    Kind::Lion, Kind::Tiger, Kind::Elephant, Kind::Eagle,
+    Kind::Parrot, Kind::Snake, Kind::Crocodile
+};
+
+// Animal as it was before ZooWorld: every field in one heap object.
+struct LegacyAnimal {
+    std::string name;
+    size_t health = 100;
+    size_t hunger = 0;
+    Kind kind;
+    int id;
+    LegacyAnimal(std::string aname, Kind k, int i) : name(aname), kind(k), id(i) {}
+    virtual ~LegacyAnimal() = default;
+};
+
+struct LegacyLion : LegacyAnimal {
+    int roarPower = 5;
+    using LegacyAnimal::LegacyAnimal;
+};
+
+static std::string nameOf(std::size_t i) { return "animal" + std::to_string(i % 1000); }
+
+// Order-sensitive hash of every hunger and health value.
+static std::uint64_t checksum(const ZooWorld& world) {
+    std::uint64_t h = 1469598103934665603ull;
+    for (std::size_t k = 0; k < kindCount; ++k) {
+        const SpeciesPool& p = world.pool(static_cast<Kind>(k));
+        for (std::size_t i = 0; i < p.size(); ++i) {
+            h = (h ^ p.hunger[i]) * 1099511628211ull;
+            h = (h ^ p.health[i]) * 1099511628211ull;
+        }
+    }
+    return h;
+}
+
+static void bench_tick(const std::vector<Kind>& kinds, const std::vector<std::uint8_t>& hungers,
+                       std::size_t n, unsigned max_threads) {
+    ZooWorld initial;
+    for (std::size_t i = 0; i < n; ++i) {
+        AnimalHandle h = initial.add(kinds[i], nameOf(i));
+        initial.pool(h.kind).hunger[initial.row(h)] = hungers[i];
+    }
+
+    const int ticks = 50;
+    double base = 0;
+    std::uint64_t expected = 0;
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        ZooWorld world = initial;
+        Zoo zoo(world, threads);
+        std::size_t fired = 0;
+        auto start = Clock::now();
+        for (int t = 0; t < ticks; ++t) {
+            TickStats stats = zoo.tick(0.75);
+            for (std::size_t b : stats.behaviours) fired += b;
+        }
+        double ms = elapsed_ms(start);
+        std::uint64_t sum = checksum(world);
+        if (threads == 1) {
+            base = ms;
+            expected = sum;
+        }
+        std::cout << "tick threads=" << std::setw(3) << threads
+                  << " ticks/s=" << std::setw(10) << ticks * 1000.0 / ms
+                  << " speedup=" << std::setw(6) << base / ms
+                  << " behaviours=" << fired
+                  << (sum == expected ? " state ok" : " STATE DIFFERS") << std::endl;
+        check(sum == expected, "tick state with " + std::to_string(threads) + " threads differs from 1 thread");
+    }
+}
+
+static void tick(std::vector<LegacyAnimal*>& animals, std::size_t& fed) {
+    for (LegacyAnimal* a : animals) {
+        if (a->hunger < 100) ++a->hunger;
+        if (a->hunger > 80 && a->health > 0) --a->health;
+    }
+    for (LegacyAnimal* a : animals) {
+        if (a->hunger >= 60) {
+            a->hunger = 0;
+            a->health = 100;
+            ++fed;
+        }
+    }
+}
+
+struct Query {
+    const char* name;
+    KindSet kinds;
+    Range hunger, health;
+};
+
+static bool inRange(size_t v, Range r) { return v >= r.min && v <= r.max; }
+
+// What ZooIndex::query must return, from a full scan of the columns.
+static std::vector<std::uint64_t> scan(const ZooWorld& world, const Query& q) {
+    std::vector<std::uint64_t> ids;
+    for (std::size_t k = 0; k < kindCount; ++k) {
+        if (!(q.kinds >> k & 1)) continue;
+        const SpeciesPool& p = world.pool(static_cast<Kind>(k));
+        for (std::size_t i = 0; i < p.size(); ++i)
+            if (inRange(p.hunger[i], q.hunger) && inRange(p.health[i], q.health)) ids.push_back(p.id[i]);
+    }
+    return ids;
+}
+
+static void checkIndex(const ZooWorld& world, const ZooIndex& index, const Query* queries, std::size_t count,
+                       const char* when) {
+    for (std::size_t i = 0; i < count; ++i) {
+        std::vector<std::uint64_t> expected = scan(world, queries[i]);
+        std::vector<std::uint64_t> found = index.query(queries[i].kinds, queries[i].hunger, queries[i].health);
+        std::sort(expected.begin(), expected.end());
+        std::sort(found.begin(), found.end());
+        check(found == expected, std::string(queries[i].name) + " " + when + ": index has " + std::to_string(found.size())
+              + " ids, scan " + std::to_string(expected.size()));
+    }
+    check(index.count(kindsOf(Kind::Animal)) == world.size(), std::string("index count ") + when);
+}
+
+static void bench_index(const std::vector<Kind>& kinds, const std::vector<std::uint8_t>& hungers,
+                        const std::vector<std::uint8_t>& healths, std::size_t n) {
+    std::cout << "index over " << n << " animals" << std::endl;
+    std::vector<std::unique_ptr<LegacyAnimal>> legacy;
+    legacy.reserve(n);
+    ZooWorld world;
+    for (Kind k : species) world.reserve(k, n / 6);
+    for (std::size_t i = 0; i < n; ++i) {
+        legacy.push_back(std::make_unique<LegacyAnimal>(nameOf(i), kinds[i], int(i)));
+        legacy.back()->hunger = hungers[i];
+        legacy.back()->health = healths[i];
+        AnimalHandle h = world.add(kinds[i], nameOf(i));
+        world.pool(h.kind).hunger[world.row(h)] = hungers[i];
+        world.pool(h.kind).health[world.row(h)] = healths[i];
+    }
+    auto start = Clock::now();
+    ZooIndex index(world);
+    std::cout << "  build ms=" << elapsed_ms(start) << std::endl;
+
+    const Query queries[] = {
+        {"hungry reptiles", kindsOf(Kind::Reptile), {80, 100}, {0, 100}},
+        {"health < 30", kindsOf(Kind::Animal), {0, 100}, {0, 29}},
+        {"starving weak lions", kindsOf(Kind::Lion), {90, 100}, {0, 49}},
+    };
+    for (const Query& q : queries) {
+        start = Clock::now();
+        std::vector<std::uint64_t> scanned;
+        for (const auto& a : legacy) {
+            if ((q.kinds >> static_cast<unsigned>(a->kind) & 1) && inRange(a->hunger, q.hunger) && inRange(a->health, q.health))
+                scanned.push_back(a->id);
+        }
+        double scan_ms = elapsed_ms(start);
+
+        start = Clock::now();
+        std::vector<std::uint64_t> found = index.query(q.kinds, q.hunger, q.health);
+        double ms = elapsed_ms(start);
+
+        std::cout << "  " << std::left << std::setw(20) << q.name
+                  << " scan ms=" << std::setw(10) << scan_ms
+                  << " index ms=" << std::setw(10) << ms
+                  << " hits " << scanned.size() << " vs " << found.size() << std::endl;
+        check(scanned.size() == found.size(), std::string(q.name) + ": index and legacy scan disagree");
+    }
+    const std::size_t queryCount = sizeof(queries) / sizeof(queries[0]);
+    checkIndex(world, index, queries, queryCount, "after build");
+
+    // Single-entry updates: feed, remove and add a spread of animals.
+    std::vector<AnimalHandle> picked;
+    for (Kind k : species) {
+        for (std::size_t r = 0; r < world.pool(k).size(); r += 97) picked.push_back(world.handleAt(k, r));
+    }
+    for (std::size_t i = 0; i < picked.size(); ++i) {
+        if (i % 3 == 0) world.remove(picked[i]);
+        else world.feed(picked[i]);
+    }
+    for (std::size_t i = 0; i < picked.size() / 3; ++i) {
+        AnimalHandle h = world.add(species[i % 7], nameOf(i));
+        world.pool(h.kind).hunger[world.row(h)] = hungers[i];
+        world.pool(h.kind).health[world.row(h)] = healths[i];
+        index.changed(h);
+    }
+    checkIndex(world, index, queries, queryCount, "after feed, remove and add");
+
+    Zoo zoo(world, 1);
+    // Hooks feed from inside the tick, after the tick's own sync.
+    zoo.onBehaviour(Kind::Lion, [&](AnimalHandle h) { world.feed(h); });
+    start = Clock::now();
+    zoo.tick(1.0);
+    double with_ms = elapsed_ms(start);
+    checkIndex(world, index, queries, queryCount, "after tick");
+    world.attach(nullptr);
+    start = Clock::now();
+    zoo.tick(1.0);
+    double without_ms = elapsed_ms(start);
+    world.attach(&index);
+    index.reindex();
+    checkIndex(world, index, queries, queryCount, "after reattach");
+    for (int t = 0; t < 5; ++t) zoo.tick(2.5);
+    world.feedHungry(60);
+    checkIndex(world, index, queries, queryCount, "after ticks and feedHungry");
+    std::cout << "  tick ms=" << without_ms << " tick+sync ms=" << with_ms << std::endl;
+}
+
+// A snapshot column equals the world's column, or both are absent.
+template <typename T, typename V>
+static bool sameColumn(const ZooSnapshot& snap, Kind kind, Column c, const std::vector<V>& values) {
+    const T* column = snap.column<T>(kind, c);
+    if (values.empty()) return column == nullptr || snap.size(kind) == 0;
+    if (!column || values.size() != snap.size(kind)) return false;
+    for (std::size_t i = 0; i < values.size(); ++i)
+        if (column[i] != static_cast<T>(values[i])) return false;
+    return true;
+}
+
+// Saves a small world with every kind, species field and some vocabularies,
+// and reads every column back; then damages the file in ways open() must
+// reject.
+static void check_snapshot() {
+    const char* path = "zoo_check.snap";
+    const char* bad = "zoo_check_bad.snap";
+    ZooWorld world;
+    for (std::size_t k = 0; k < kindCount; ++k) {
+        Kind kind = static_cast<Kind>(k);
+        std::vector<AnimalHandle> handles;
+        for (std::size_t i = 0; i < 5; ++i) {
+            handles.push_back(world.add(kind, "snap " + std::to_string(k) + " " + std::to_string(i)));
+            SpeciesPool& p = world.pool(kind);
+            std::size_t r = world.row(handles.back());
+            p.hunger[r] = static_cast<std::uint8_t>(k * 7 + i);
+            p.health[r] = static_cast<std::uint8_t>(100 - k * 3 - i);
+            if (!p.roarPower.empty()) p.roarPower[r] = int(k * 10 + i);
+            if (!p.jumpHeight.empty()) p.jumpHeight[r] = 1.5 + i;
+            if (!p.trunkLength.empty()) p.trunkLength[r] = 2.25 * i;
+            if (!p.wingSpan.empty()) p.wingSpan[r] = 0.5 + k + i;
+            if (!p.visionRange.empty()) p.visionRange[r] = 100.0 * i;
+            if (!p.poisonous.empty()) p.poisonous[r] = i % 2;
+            if (!p.biteForce.empty()) p.biteForce[r] = int(1000 + i);
+            if (!p.vocabulary.empty()) {
+                for (std::size_t w = 0; w < i; ++w) p.vocabulary[r].push_back(Symbols::intern("word " + std::to_string(w * 3 + i)));
+                if (i % 2) p.vocabulary[r].push_back(Symbols::intern("snap " + std::to_string(k) + " 0"));
+            }
+        }
+        // Rows move on removal; the snapshot must follow the columns.
+        world.remove(handles[1]);
+    }
+    if (!saveSnapshot(world, path)) {
+        check(false, "snapshot save failed");
+        return;
+    }
+
+    ZooSnapshot snap;
+    check(snap.open(path), "snapshot open failed");
+    for (std::size_t k = 0; k < kindCount; ++k) {
+        Kind kind = static_cast<Kind>(k);
+        const SpeciesPool& p = world.pool(kind);
+        std::string where = " of kind " + std::to_string(k);
+        check(snap.size(kind) == p.size(), "snapshot rows" + where);
+        check(sameColumn<std::uint64_t>(snap, kind, Column::Id, p.id), "snapshot ids" + where);
+        check(sameColumn<std::uint8_t>(snap, kind, Column::Hunger, p.hunger), "snapshot hunger" + where);
+        check(sameColumn<std::uint8_t>(snap, kind, Column::Health, p.health), "snapshot health" + where);
+        check(sameColumn<std::int32_t>(snap, kind, Column::RoarPower, p.roarPower), "snapshot roarPower" + where);
+        check(sameColumn<double>(snap, kind, Column::JumpHeight, p.jumpHeight), "snapshot jumpHeight" + where);
+        check(sameColumn<double>(snap, kind, Column::TrunkLength, p.trunkLength), "snapshot trunkLength" + where);
+        check(sameColumn<double>(snap, kind, Column::WingSpan, p.wingSpan), "snapshot wingSpan" + where);
+        check(sameColumn<double>(snap, kind, Column::VisionRange, p.visionRange), "snapshot visionRange" + where);
+        check(sameColumn<std::uint8_t>(snap, kind, Column::Poisonous, p.poisonous), "snapshot poisonous" + where);
+        check(sameColumn<std::int32_t>(snap, kind, Column::BiteForce, p.biteForce), "snapshot biteForce" + where);
+
+        const std::uint32_t* names = snap.column<std::uint32_t>(kind, Column::Name);
+        bool namesOk = names != nullptr;
+        for (std::size_t r = 0; namesOk && r < p.size(); ++r)
+            namesOk = snap.string(names[r]) == Symbols::str(p.name[r]) && snap.name(kind, r) == Symbols::str(p.name[r]);
+        check(namesOk, "snapshot names" + where);
+    }
+
+    const SpeciesPool& parrots = world.pool(Kind::Parrot);
+    bool wordsOk = true;
+    for (std::size_t r = 0; r < parrots.size(); ++r) {
+        wordsOk = wordsOk && snap.vocabularySize(r) == parrots.vocabulary[r].size();
+        for (std::size_t i = 0; wordsOk && i < parrots.vocabulary[r].size(); ++i)
+            wordsOk = snap.word(r, i) == Symbols::str(parrots.vocabulary[r][i]);
+    }
+    check(wordsOk, "snapshot Parrot vocabularies");
+    check(snap.vocabularySize(parrots.size()) == 0 && snap.word(0, 99).empty(), "snapshot vocabulary out of range");
+
+    std::string bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    auto opens = [&](const std::string& contents) {
+        std::ofstream(bad, std::ios::binary).write(contents.data(), contents.size());
+        ZooSnapshot damaged;
+        return damaged.open(bad);
+    };
+    check(opens(bytes), "snapshot copy should open");
+    for (std::size_t keep : {std::size_t(16), bytes.size() / 2, bytes.size() - 1})
+        check(!opens(bytes.substr(0, keep)), "snapshot truncated to " + std::to_string(keep) + " bytes should not open");
+    std::string wrongMagic = bytes;
+    wrongMagic[0] = 'X';
+    check(!opens(wrongMagic), "snapshot with a bad magic should not open");
+
+    snap.close();
+    std::remove(path);
+    std::remove(bad);
+}
+
+static void bench_snapshot(const std::vector<Kind>& kinds, const std::vector<std::uint8_t>& hungers, std::size_t n) {
+    const char* path = "zoo_bench.snap";
+    std::size_t fileSize = 0, total = 0;
+    double save_ms = 0;
+    {
+        ZooWorld world;
+        for (Kind k : species) world.reserve(k, n / 6);
+        for (std::size_t i = 0; i < n; ++i) {
+            AnimalHandle h = world.add(kinds[i], nameOf(i));
+            world.pool(h.kind).hunger[world.row(h)] = hungers[i];
+            if (h.kind == Kind::Parrot) world.pool(h.kind).vocabulary[world.row(h)] = {Symbols::intern("Hello"), Symbols::intern("Pretty bird")};
+        }
+        auto start = Clock::now();
+        if (!saveSnapshot(world, path)) return;
+        save_ms = elapsed_ms(start);
+    }
+
+    auto start = Clock::now();
+    ZooSnapshot snap;
+    if (!snap.open(path)) return;
+    double open_ms = elapsed_ms(start);
+    fileSize = snap.fileSize();
+
+    start = Clock::now();
+    for (Kind k : species) {
+        const std::uint8_t* hunger = snap.hunger(k);
+        for (std::size_t i = 0; i < snap.size(k); ++i) total += hunger[i];
+    }
+    double scan_ms = elapsed_ms(start);
+    snap.close();
+    std::remove(path);
+
+    std::cout << "snapshot of " << n << " animals: " << fileSize / double(1 << 20) << " MiB ("
+              << double(fileSize) / n << " B/animal)" << std::endl;
+    std::cout << "  save ms=" << save_ms << " open ms=" << open_ms
+              << " first hunger pass ms=" << scan_ms << " (sum " << total << ")" << std::endl;
+}
+
+// PrintInfo as it was, flushing every line.
+static void legacyPrintInfo(std::ostream& out, const LegacyAnimal& a) {
+    out << "Name: " << a.name << std::endl;
+    out << "Animal class: Mamal" << std::endl;
+    out << "Animal species: Lion" << std::endl;
+    out << "Hunger: " << a.hunger << std::endl;
+    out << "Health: " << a.health << std::endl;
+    out << "id: " << a.id << std::endl;
+}
+
+static void bench_report(const std::vector<Kind>& kinds, std::size_t n) {
+    const char* path = "zoo_report_bench.txt";
+    std::size_t bytes = 0;
+    {
+        std::vector<LegacyAnimal> legacy;
+        legacy.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) legacy.emplace_back(nameOf(i), kinds[i], int(i));
+        std::ofstream out(path);
+        auto start = Clock::now();
+        for (const LegacyAnimal& a : legacy) legacyPrintInfo(out, a);
+        double ms = elapsed_ms(start);
+        bytes = out.tellp();
+        std::cout << std::left << std::setw(22) << "PrintInfo + endl" << " ms=" << std::setw(10) << ms
+                  << " MiB=" << bytes / double(1 << 20) << std::endl;
+    }
+
+    ZooWorld world;
+    for (std::size_t i = 0; i < n; ++i) world.add(kinds[i], nameOf(i));
+    const std::pair<const char*, ReportFormat> formats[] = {
+        {"ReportWriter text", ReportFormat::Text},
+        {"ReportWriter CSV", ReportFormat::Csv},
+        {"ReportWriter JSONL", ReportFormat::JsonLines},
+    };
+    for (const auto& f : formats) {
+        std::ofstream out(path);
+        auto start = Clock::now();
+        {
+            ReportWriter writer(out, f.second);
+            reportAnimals(writer, world);
+        }
+        double ms = elapsed_ms(start);
+        bytes = out.tellp();
+        std::cout << std::left << std::setw(22) << f.first << " ms=" << std::setw(10) << ms
+                  << " MiB=" << bytes / double(1 << 20) << std::endl;
+    }
+    std::remove(path);
+}
+
+// The old hierarchy with the trait behind a virtual call.
+struct PolyAnimal {
+    size_t hunger = 0;
+    virtual double Trait() const = 0;
+    virtual ~PolyAnimal() = default;
+};
+
+template <Kind K, typename T>
+struct PolySpecies : PolyAnimal {
+    T value;
+    explicit PolySpecies(T v) : value(v) {}
+    double Trait() const override { return double(value) + hunger; }
+};
+
+// The old hierarchy reached by switching on Kind and casting.
+struct TaggedAnimal {
+    Kind kind;
+    size_t hunger = 0;
+    explicit TaggedAnimal(Kind k) : kind(k) {}
+    virtual ~TaggedAnimal() = default;
+};
+
+template <Kind K, typename T>
+struct TaggedSpecies : TaggedAnimal {
+    T value;
+    explicit TaggedSpecies(T v) : TaggedAnimal(K), value(v) {}
+};
+
+template <Kind K, typename T>
+static double taggedTrait(const TaggedAnimal* a) {
+    return double(static_cast<const TaggedSpecies<K, T>*>(a)->value) + a->hunger;
+}
+
+static double trait(const TaggedAnimal* a) {
+    switch (a->kind) {
+        case Kind::Lion:      return taggedTrait<Kind::Lion, int>(a);
+        case Kind::Tiger:     return taggedTrait<Kind::Tiger, double>(a);
+        case Kind::Elephant:  return taggedTrait<Kind::Elephant, double>(a);
+        case Kind::Eagle:     return taggedTrait<Kind::Eagle, double>(a);
+        case Kind::Parrot:    return taggedTrait<Kind::Parrot, int>(a);
+        case Kind::Snake:     return taggedTrait<Kind::Snake, bool>(a);
+        case Kind::Crocodile: return taggedTrait<Kind::Crocodile, int>(a);
+        default:              return 0;
+    }
+}
+
+static const auto viewTrait = overloaded{
+    [](const Lion& a) { return double(a.RoarPower()) + a.Hunger(); },
+    [](const Tiger& a) { return a.JumpHeight() + a.Hunger(); },
+    [](const Elephant& a) { return a.TrunkLength() + a.Hunger(); },
+    [](const Eagle& a) { return a.VisionRange() + a.Hunger(); },
+    [](const Parrot& a) { return double(a.Vocabulary().size()) + a.Hunger(); },
+    [](const Snake& a) { return double(a.Poisonous()) + a.Hunger(); },
+    [](const Crocodile& a) { return double(a.BiteForce()) + a.Hunger(); },
+};
+
+static void bench_visit(const std::vector<Kind>& kinds, std::size_t n) {
+    std::vector<std::unique_ptr<PolyAnimal>> poly;
+    std::vector<std::unique_ptr<TaggedAnimal>> tagged;
+    ZooWorld world;
+    std::vector<AnimalRef> refs;
+    AnimalRefs split;
+    poly.reserve(n);
+    tagged.reserve(n);
+    refs.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        switch (kinds[i]) {
+            case Kind::Lion:
+                poly.push_back(std::make_unique<PolySpecies<Kind::Lion, int>>(5));
+                tagged.push_back(std::make_unique<TaggedSpecies<Kind::Lion, int>>(5));
+                break;
+            case Kind::Tiger:
+                poly.push_back(std::make_unique<PolySpecies<Kind::Tiger, double>>(3.5));
+                tagged.push_back(std::make_unique<TaggedSpecies<Kind::Tiger, double>>(3.5));
+                break;
+            case Kind::Elephant:
+                poly.push_back(std::make_unique<PolySpecies<Kind::Elephant, double>>(2.4));
+                tagged.push_back(std::make_unique<TaggedSpecies<Kind::Elephant, double>>(2.4));
+                break;
+            case Kind::Eagle:
+                poly.push_back(std::make_unique<PolySpecies<Kind::Eagle, double>>(100.0));
+                tagged.push_back(std::make_unique<TaggedSpecies<Kind::Eagle, double>>(100.0));
+                break;
+            case Kind::Parrot:
+                poly.push_back(std::make_unique<PolySpecies<Kind::Parrot, int>>(0));
+                tagged.push_back(std::make_unique<TaggedSpecies<Kind::Parrot, int>>(0));
+                break;
+            case Kind::Snake:
+                poly.push_back(std::make_unique<PolySpecies<Kind::Snake, bool>>(false));
+                tagged.push_back(std::make_unique<TaggedSpecies<Kind::Snake, bool>>(false));
+                break;
+            default:
+                poly.push_back(std::make_unique<PolySpecies<Kind::Crocodile, int>>(5));
+                tagged.push_back(std::make_unique<TaggedSpecies<Kind::Crocodile, int>>(5));
+                break;
+        }
+        refs.push_back(*makeRef(world, world.add(kinds[i], nameOf(i))));
+        split.push_back(refs.back());
+    }
+
+    const int rounds = 5;
+    double sums[4] = {};
+    double ms[4];
+
+    auto start = Clock::now();
+    for (int r = 0; r < rounds; ++r)
+        for (const auto& a : poly) sums[0] += a->Trait();
+    ms[0] = elapsed_ms(start);
+
+    start = Clock::now();
+    for (int r = 0; r < rounds; ++r)
+        for (const auto& a : tagged) sums[1] += trait(a.get());
+    ms[1] = elapsed_ms(start);
+
+    start = Clock::now();
+    for (int r = 0; r < rounds; ++r)
+        for (const AnimalRef& a : refs) sums[2] += std::visit(viewTrait, a);
+    ms[2] = elapsed_ms(start);
+
+    start = Clock::now();
+    for (int r = 0; r < rounds; ++r)
+        split.visit([&](const auto& a) { sums[3] += viewTrait(a); });
+    ms[3] = elapsed_ms(start);
+
+    const char* names[4] = {"virtual Trait()", "switch on Kind", "visit vector<AnimalRef>", "AnimalRefs::visit"};
+    for (int i = 0; i < 4; ++i) {
+        std::cout << std::left << std::setw(24) << names[i]
+                  << " ns/animal=" << std::setw(10) << ms[i] * 1e6 / (double(n) * rounds)
+                  << " (sum " << sums[i] << ")" << std::endl;
+    }
+}
+
+// Heap and inline bytes of the old string columns.
+static std::size_t stringBytes(const std::string& s) {
+    return sizeof(std::string) + (s.capacity() > 15 ? s.capacity() + 1 : 0);
+}
+
+static std::string phraseOf(std::size_t i) { return "Polly wants cracker " + std::to_string(i % 256); }
+
+static void bench_symbols(const std::vector<Kind>& kinds, std::size_t n, unsigned threads) {
+    std::vector<std::string> names;
+    std::vector<std::vector<std::string>> vocabularies;
+    ZooWorld world;
+    names.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        names.push_back(nameOf(i));
+        AnimalHandle h = world.add(kinds[i], names.back());
+        if (h.kind != Kind::Parrot) continue;
+        std::vector<std::string> words{phraseOf(i), phraseOf(i * 7), "Hello", "Pretty bird"};
+        std::vector<Symbol>& symbols = world.pool(h.kind).vocabulary[world.row(h)];
+        for (const std::string& w : words) symbols.push_back(Symbols::intern(w));
+        vocabularies.push_back(std::move(words));
+    }
+
+    std::size_t stringMemory = names.capacity() * sizeof(std::string) - names.size() * sizeof(std::string);
+    for (const std::string& s : names) stringMemory += stringBytes(s);
+    stringMemory += vocabularies.capacity() * sizeof(std::vector<std::string>);
+    for (const std::vector<std::string>& words : vocabularies) {
+        stringMemory += words.capacity() * sizeof(std::string) - words.size() * sizeof(std::string);
+        for (const std::string& w : words) stringMemory += stringBytes(w);
+    }
+    std::size_t symbolMemory = 0;
+    for (std::size_t k = 0; k < kindCount; ++k) {
+        const SpeciesPool& p = world.pool(static_cast<Kind>(k));
+        symbolMemory += p.name.capacity() * sizeof(Symbol) + p.vocabulary.capacity() * sizeof(std::vector<Symbol>);
+        for (const std::vector<Symbol>& words : p.vocabulary) symbolMemory += words.capacity() * sizeof(Symbol);
+    }
+    std::cout << "  strings MiB=" << stringMemory / double(1 << 20)
+              << " symbols MiB=" << symbolMemory / double(1 << 20)
+              << " + interner MiB=" << Symbols::bytes() / double(1 << 20)
+              << " (" << Symbols::size() << " strings)" << std::endl;
+
+    auto start = Clock::now();
+    for (const std::string& s : names) Symbols::intern(s);
+    double known_ms = elapsed_ms(start);
+
+    std::vector<std::string> fresh(n);
+    for (std::size_t i = 0; i < n; ++i) fresh[i] = "symbol bench " + std::to_string(i);
+    for (unsigned t : {1u, threads}) {
+        std::size_t base = t == 1 ? 0 : n / 2;
+        std::size_t count = t == 1 ? n / 2 : n - n / 2;
+        start = Clock::now();
+        std::vector<std::thread> pool;
+        for (unsigned w = 0; w < t; ++w) {
+            pool.emplace_back([&, w] {
+                for (std::size_t i = base + w; i < base + count; i += t) Symbols::intern(fresh[i]);
+            });
+        }
+        for (std::thread& th : pool) th.join();
+        double ms = elapsed_ms(start);
+        std::cout << "  intern new, " << std::setw(2) << t << " threads ns/string=" << ms * 1e6 / double(count) << std::endl;
+    }
+    std::cout << "  intern known ns/string=" << known_ms * 1e6 / double(n) << std::endl;
+
+    std::size_t lost = 0;
+    for (const std::string& s : fresh) {
+        Symbol sym = Symbols::find(s);
+        lost += sym == Symbol{} || Symbols::str(sym) != s;
+    }
+    check(lost == 0, std::to_string(lost) + " strings interned from threads do not round-trip through str");
+
+    // Every thread interns the same strings, each in its own order, and must
+    // get the same symbols back.
+    const unsigned racers = std::max(threads, 4u);
+    const std::size_t shared = std::min<std::size_t>(n, 4096);
+    std::vector<std::string> contested(shared);
+    for (std::size_t i = 0; i < shared; ++i) contested[i] = "symbol race " + std::to_string(i);
+    std::vector<std::vector<Symbol>> got(racers, std::vector<Symbol>(shared));
+    std::vector<std::thread> pool;
+    for (unsigned w = 0; w < racers; ++w) {
+        pool.emplace_back([&, w] {
+            for (std::size_t j = 0; j < shared; ++j) {
+                std::size_t i = (j + w * shared / racers) % shared;
+                if (w % 2) i = shared - 1 - i;
+                got[w][i] = Symbols::intern(contested[i]);
+            }
+        });
+    }
+    for (std::thread& th : pool) th.join();
+    std::size_t differ = 0, broken = 0;
+    for (std::size_t i = 0; i < shared; ++i) {
+        for (unsigned w = 1; w < racers; ++w) differ += got[w][i] != got[0][i];
+        broken += Symbols::str(got[0][i]) != contested[i] || Symbols::find(contested[i]) != got[0][i];
+    }
+    check(differ == 0, std::to_string(differ) + " symbols differ between threads interning the same strings");
+    check(broken == 0, std::to_string(broken) + " concurrently interned symbols do not round-trip through str");
+
+    std::size_t wrongWords = 0, parrot = 0;
+    const SpeciesPool& parrots = world.pool(Kind::Parrot);
+    for (std::size_t r = 0; r < parrots.size(); ++r, ++parrot) {
+        for (std::size_t w = 0; w < parrots.vocabulary[r].size(); ++w)
+            wrongWords += Symbols::str(parrots.vocabulary[r][w]) != vocabularies[parrot][w];
+    }
+    check(wrongWords == 0, std::to_string(wrongWords) + " Parrot words do not round-trip through str");
+
+    start = Clock::now();
+    std::size_t chars = 0;
+    for (std::size_t k = 0; k < kindCount; ++k)
+        for (Symbol s : world.pool(static_cast<Kind>(k)).name) chars += Symbols::str(s).size();
+    std::cout << "  str ns/symbol=" << elapsed_ms(start) * 1e6 / double(n) << " (" << chars << " chars)" << std::endl;
+
+    const int rounds = 20;
+    std::size_t byString = 0, bySymbol = 0;
+    start = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        std::string wanted = nameOf(r);
+        for (const std::string& s : names) byString += s == wanted;
+    }
+    double string_ms = elapsed_ms(start);
+    start = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        Symbol wanted = Symbols::find(nameOf(r));
+        for (std::size_t k = 0; k < kindCount; ++k)
+            for (Symbol s : world.pool(static_cast<Kind>(k)).name) bySymbol += s == wanted;
+    }
+    double symbol_ms = elapsed_ms(start);
+    std::cout << "  find by name ns/animal: strings=" << string_ms * 1e6 / (double(n) * rounds)
+              << " symbols=" << symbol_ms * 1e6 / (double(n) * rounds)
+              << " (" << byString << " / " << bySymbol << " found)" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    const int ticks = 20;
+
+    std::mt19937 rng(5);
+    std::vector<Kind> kinds(n);
+    std::vector<std::uint8_t> hungers(n), healths(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        kinds[i] = species[rng() % 7];
+        hungers[i] = rng() % 100;
+        healths[i] = rng() % 101;
+    }
+
+    std::size_t legacy_fed = 0, fed = 0;
+    {
+        std::vector<std::unique_ptr<LegacyAnimal>> owned;
+        std::vector<LegacyAnimal*> animals;
+        owned.reserve(n);
+        animals.reserve(n);
+        auto start = Clock::now();
+        for (std::size_t i = 0; i < n; ++i) {
+            if (kinds[i] == Kind::Lion) owned.push_back(std::make_unique<LegacyLion>(nameOf(i), kinds[i], int(i)));
+            else owned.push_back(std::make_unique<LegacyAnimal>(nameOf(i), kinds[i], int(i)));
+            animals.push_back(owned.back().get());
+            animals.back()->hunger = hungers[i];
+        }
+        double build_ms = elapsed_ms(start);
+
+        start = Clock::now();
+        for (int t = 0; t < ticks; ++t) tick(animals, legacy_fed);
+        double ms = elapsed_ms(start);
+        std::cout << std::left << std::setw(22) << "vector<Animal*>"
+                  << " build ms=" << std::setw(10) << build_ms
+                  << " ns/animal/tick=" << ms * 1e6 / (double(n) * ticks) << std::endl;
+    }
+    {
+        ZooWorld world;
+        for (Kind k : species) world.reserve(k, n / 6);
+        auto start = Clock::now();
+        for (std::size_t i = 0; i < n; ++i) {
+            AnimalHandle h = world.add(kinds[i], nameOf(i));
+            world.pool(h.kind).hunger[world.row(h)] = hungers[i];
+        }
+        double build_ms = elapsed_ms(start);
+
+        start = Clock::now();
+        for (int t = 0; t < ticks; ++t) {
+            world.update(80);
+            fed += world.feedHungry(60);
+        }
+        double ms = elapsed_ms(start);
+        std::cout << std::left << std::setw(22) << "ZooWorld columns"
+                  << " build ms=" << std::setw(10) << build_ms
+                  << " ns/animal/tick=" << ms * 1e6 / (double(n) * ticks) << std::endl;
+    }
+    std::cout << "(fed " << legacy_fed << " vs " << fed << ")" << std::endl;
+
+    unsigned hw = std::thread::hardware_concurrency();
+    unsigned max_threads = argc > 2 ? std::atoi(argv[2]) : std::max(4u, hw);
+    std::cout << "hardware threads: " << hw << std::endl;
+    bench_tick(kinds, hungers, n / 10, max_threads);
+
+    bench_index(kinds, hungers, healths, n / 10);
+    bench_index(kinds, hungers, healths, n);
+
+    check_snapshot();
+    bench_snapshot(kinds, hungers, n);
+
+    std::cout << "report of " << n / 10 << " animals" << std::endl;
+    bench_report(kinds, n / 10);
+
+    std::cout << "dispatch over " << n / 10 << " animals" << std::endl;
+    bench_visit(kinds, n / 10);
+
+    std::cout << "symbols of " << n / 10 << " animals" << std::endl;
+    bench_symbols(kinds, n / 10, max_threads);
+
+    if (failures) {
+        std::cout << failures << " checks FAILED" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -1,4 +1,5 @@
 #include "Zoo.hpp"
+#include "AnimalRef.hpp"
 #include <iostream>
 #include <vector>
 
@@ -29,6 +30,24 @@ int main() {
     aquila->Soar();
     sly->Hiss();
 
+    std::cout << "\n=== SHOW TIME ===" << std::endl;
+    for (Animal* a : animals) {
+        if (std::optional<AnimalRef> ref = makeRef(ZooWorld::global(), a->Handle())) act(*ref);
+    }
+
+    std::cout << "\n=== A DAY AT THE ZOO ===" << std::endl;
+    Zoo zoo;
+    ZooWorld& world = zoo.world();
+    zoo.onBehaviour(Kind::Lion, [&](AnimalHandle h) { Lion(world, h).Roar(); });
+    zoo.onBehaviour(Kind::Tiger, [&](AnimalHandle h) { Tiger(world, h).Jump(); });
+    zoo.onBehaviour(Kind::Eagle, [&](AnimalHandle h) { Eagle(world, h).Soar(); });
+    zoo.onBehaviour(Kind::Snake, [&](AnimalHandle h) { Snake(world, h).Hiss(); });
+    for (int hour = 6; hour <= 24; hour += 6) {
+        std::cout << "Hour " << hour << std::endl;
+        TickStats stats = zoo.tick(6);
+        std::cout << stats.starving << " starving" << std::endl;
+    }
+
     return 0;
 
 